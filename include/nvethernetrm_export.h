@@ -198,6 +198,17 @@ struct osi_fpe_config {
 	 * Value range for EQOS 1-7
 	 * Value range for MGBE 1-9 */
 	nveu32_t rq;
+#ifndef OSI_STRIPPED_LIB
+	/** Min non-final fragment size in bytes, multiple of 64 up to 256,
+	 * 0 for 64 */
+	nveu32_t frag_size;
+	/** OSI_ENABLE to start at frag_size and step it up while preempted
+	 * frames are split in many TX fragments per hold request, and back
+	 * down once that stays low. Tuned on OSI_CMD_READ_STATS. Needs EST
+	 * gate hold/release operations, without EST no hold request is
+	 * counted and the fragment size stays at frag_size */
+	nveu32_t frag_auto;
+#endif /* !OSI_STRIPPED_LIB */
 };
 
 /**
@@ -243,6 +254,39 @@ struct osi_stats {
 	nveu64_t ts_lock_add_fail;
 	/** lock fail count node removal */
 	nveu64_t ts_lock_del_fail;
+	/** PTP M2M servo offset samples processed */
+	nveu64_t m2m_servo_samples;
+	/** PTP M2M servo resets due to an offset of 1 sec or more */
+	nveu64_t m2m_servo_jumps;
+	/** PTP M2M servo samples in locked state since last reset */
+	nveu64_t m2m_servo_locked_samples;
+	/** PTP M2M servo last absolute offset in ns */
+	nveu64_t m2m_servo_last_offset;
+	/** Timestamp addend register update count */
+	nveu64_t ptp_addend_writes;
+	/** FPE additional mPackets transmitted due to preemption */
+	nveu64_t fpe_tx_frag_n;
+	/** FPE hold requests given to MAC, each ends with a release */
+	nveu64_t fpe_hold_req_n;
+	/** FPE additional mPackets received due to preemption */
+	nveu64_t fpe_rx_frag_n;
+	/** FPE frames reassembled successfully */
+	nveu64_t fpe_rx_asm_ok_n;
+	/** FPE frames with reassembly errors */
+	nveu64_t fpe_rx_asm_err_n;
+	/** FPE frames and fragments rejected due to SMD errors */
+	nveu64_t fpe_rx_smd_err_n;
+	/** FPE verify/response exchanges completed with link partner */
+	nveu64_t fpe_verify_ok_n;
+	/** FPE min non-final fragment size in bytes, 0 if FPE is off */
+	nveu64_t fpe_frag_size;
+	/** Pause frames transmitted, PFC frames included */
+	nveu64_t pfc_tx_pause_n;
+	/** Pause frames received, PFC frames included */
+	nveu64_t pfc_rx_pause_n;
+	/** Per VLAN priority count of stats reads that found an RX queue
+	 * of the priority above its PFC activate threshold */
+	nveu64_t pfc_congested_n[OSI_MAX_TC_NUM];
 #endif
 };
 
@@ -81,6 +81,19 @@ typedef my_lint_64		nvel64_t;
 #define OSI_CMD_SET_MODE		16U
 #define OSI_CMD_POLL_FOR_MAC_RST	4U
 #define OSI_CMD_GET_MAC_VER		10U
+#define OSI_CMD_CONFIG_PPS		57U
+#define OSI_CMD_FRP_EVAL		58U
+#define OSI_CMD_FLOW_STEER		59U
+#define OSI_CMD_L2_ADDR_LIST		60U
+#define OSI_CMD_VLAN_LIST		61U
+#define OSI_CMD_RSS_REBALANCE		62U
+#define OSI_CMD_RSS_HASH		63U
+#define OSI_CMD_RSS_UPDATE		64U
+#define OSI_CMD_RXQ_REMAP		65U
+#define OSI_CMD_EST_WAIT_SWAP		66U
+#define OSI_CMD_EST_PLAN		67U
+#define OSI_CMD_CONFIG_CBS		68U
+#define OSI_CMD_CONFIG_PFC		69U
 
 /**
  * @addtogroup PTP-offload PTP offload defines
@@ -327,7 +340,7 @@ typedef my_lint_64		nvel64_t;
  * @{
  */
 #ifndef OSI_STRIPPED_LIB
-#define OSI_FRP_CMD_MAX			3U
+#define OSI_FRP_CMD_MAX			6U
 #define OSI_FRP_MATCH_MAX		10U
 #endif /* !OSI_STRIPPED_LIB */
 #define OSI_FRP_MAX_ENTRY		256U
@@ -336,6 +349,12 @@ typedef my_lint_64		nvel64_t;
 #define OSI_FRP_CMD_ADD			0U
 #define OSI_FRP_CMD_UPDATE		1U
 #define OSI_FRP_CMD_DEL			2U
+/* FRP transaction: add/update/delete between BEGIN and COMMIT only
+ * update the FRP table, HW is programmed once on COMMIT. ABORT, or COMMIT
+ * after a failed command, restores the FRP table as it was on BEGIN. */
+#define OSI_FRP_CMD_BEGIN		3U
+#define OSI_FRP_CMD_COMMIT		4U
+#define OSI_FRP_CMD_ABORT		5U
 /* FRP Filter mode defines */
 #define OSI_FRP_MODE_ROUTE		0U
 #define OSI_FRP_MODE_DROP		1U
@@ -359,6 +378,63 @@ typedef my_lint_64		nvel64_t;
 #define OSI_FRP_MATCH_VLAN		9U
 /** @} */
 
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @addtogroup Flow steering related information
+ *
+ * @brief Flow steering commands, flow spec fields and table size.
+ * IPv4 fields assume a 20 byte IPv4 header, L4 ports need IP protocol
+ * TCP or UDP.
+ * @{
+ */
+#define OSI_FLOW_CMD_ADD		0U
+#define OSI_FLOW_CMD_DEL		1U
+#define OSI_FLOW_CMD_GET		2U
+#define OSI_FLOW_ETHTYPE		OSI_BIT(0)
+#define OSI_FLOW_VLAN			OSI_BIT(1)
+#define OSI_FLOW_IP4_SRC		OSI_BIT(2)
+#define OSI_FLOW_IP4_DST		OSI_BIT(3)
+#define OSI_FLOW_IP4_PROTO		OSI_BIT(4)
+#define OSI_FLOW_L4_SRC			OSI_BIT(5)
+#define OSI_FLOW_L4_DST			OSI_BIT(6)
+#define OSI_FLOW_FIELDS_MASK		0x7FU
+#define OSI_MAX_FLOWS			64U
+#define OSI_MAX_L2_ADDR_LIST		512U
+#define OSI_RSS_REBAL_MOVES		8U
+#define OSI_RSS_REBAL_MAX_PCT		1000U
+#define OSI_RSS_IPV4			4U
+#define OSI_RSS_IPV6			6U
+#define OSI_RSS_L4_TCP			6U
+#define OSI_RSS_L4_UDP			17U
+/* RSS hash field selection, IPv4 and IPv6 alike */
+#define OSI_RSS_HASH_IP			OSI_BIT(0)
+#define OSI_RSS_HASH_TCP		OSI_BIT(1)
+#define OSI_RSS_HASH_UDP		OSI_BIT(2)
+#define OSI_RSS_HASH_DEFAULT		(OSI_RSS_HASH_IP | OSI_RSS_HASH_TCP | \
+					 OSI_RSS_HASH_UDP)
+/* RSS partial update selection */
+#define OSI_RSS_UPD_KEY			OSI_BIT(0)
+#define OSI_RSS_UPD_TABLE		OSI_BIT(1)
+#define OSI_RSS_UPD_FIELDS		OSI_BIT(2)
+#define OSI_RSS_UPD_MASK		(OSI_RSS_UPD_KEY | OSI_RSS_UPD_TABLE | \
+					 OSI_RSS_UPD_FIELDS)
+/* MTL queue roles for FIFO partitioning, see osi_mtl_q_profile */
+#define OSI_MTL_Q_ROLE_DEFAULT		0U
+#define OSI_MTL_Q_ROLE_BULK		1U
+#define OSI_MTL_Q_ROLE_LATENCY		2U
+#define OSI_MTL_Q_ROLE_PTP		3U
+#define OSI_MTL_Q_ROLE_JUMBO		4U
+#define OSI_MTL_Q_ROLE_MAX		5U
+#define OSI_MTL_Q_WEIGHT_MAX		100U
+/* EST planner limits */
+#define OSI_EST_PLAN_BW_MAX		1000U
+#define OSI_EST_PLAN_DFLT_CYCLE_NS	1000000U
+/* CBS calculator limits */
+#define OSI_CBS_BW_MAX			1000U
+#define OSI_CBS_DFLT_MAX_BW		750U
+/** @} */
+#endif /* !OSI_STRIPPED_LIB */
+
 #define XPCS_WRITE_FAIL_CODE	-9
 
 #ifdef HSI_SUPPORT
@@ -843,6 +919,46 @@ struct osi_pto_config {
 	nveu32_t portid;
 };
 
+/**
+ * @brief Maximum number of flexible PPS outputs supported by MAC
+ */
+#define OSI_MAX_PPS_OUT		4U
+
+/**
+ * @brief osi_pps_config - Flexible PPS output (pulse train) configuration
+ */
+struct osi_pps_config {
+	/** PPS output index, max OSI_MAX_PPS_OUT and HW pps_out_num */
+	nveu32_t idx;
+	/** OSI_ENABLE to start pulse train, OSI_DISABLE to stop it */
+	nveu32_t enable;
+	/** Start time seconds. If zero or already passed, pulse train
+	 * is scheduled at next second boundary with at least 1 sec margin
+	 * keeping start_nsec as phase */
+	nveu32_t start_sec;
+	/** Start time nano seconds, less than OSI_NSEC_PER_SEC */
+	nveu32_t start_nsec;
+	/** Pulse period in nano seconds */
+	nveu32_t period_ns;
+	/** Pulse width (high time) in nano seconds, less than period_ns */
+	nveu32_t width_ns;
+};
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief osi_mtl_q_profile - MTL queue traffic profile used to partition
+ * MTL TX/RX FIFO memory between the enabled queues.
+ */
+struct osi_mtl_q_profile {
+	/** OSI_MTL_Q_ROLE_* of the queue. With all enabled queues at
+	 * OSI_MTL_Q_ROLE_DEFAULT the fixed per MAC FIFO layout is used */
+	nveu32_t role;
+	/** Share of the FIFO left after role minimums, relative to the other
+	 * bulk/jumbo queues, max OSI_MTL_Q_WEIGHT_MAX, 0 is treated as 1 */
+	nveu32_t weight;
+};
+
+#endif /* !OSI_STRIPPED_LIB */
 /**
  * @brief osi_core_rss - Struture used to store RSS Hash key and table
  * information.
@@ -854,6 +970,11 @@ struct osi_core_rss {
 	nveu8_t key[OSI_RSS_HASH_KEY_SIZE];
 	/** Array for storing RSS Hash table */
 	nveu32_t table[OSI_RSS_MAX_TABLE_SIZE];
+#ifndef OSI_STRIPPED_LIB
+	/** OSI_RSS_HASH_* traffic classes hashed on L3 or L4 fields,
+	 * 0 for OSI_RSS_HASH_DEFAULT */
+	nveu32_t hash_fields;
+#endif /* !OSI_STRIPPED_LIB */
 };
 
 /**
@@ -1105,6 +1226,240 @@ struct osi_core_frp_entry {
 	struct osi_core_frp_data data;
 };
 
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief osi_frp_eval - Frame evaluation against FRP table
+ */
+struct osi_frp_eval {
+	/** Frame data starting from L2 destination address */
+	const nveu8_t *frame;
+	/** Frame length in bytes */
+	nveu32_t len;
+	/** Output: OSI_FRP_MODE_ROUTE, OSI_FRP_MODE_DROP or
+	 * OSI_FRP_MODE_BYPASS */
+	nveu32_t action;
+	/** Output: DMA channel selection (1-bit for each) on route */
+	nveu32_t dma_sel;
+	/** Output: Index of the instruction which decided the action */
+	nveu32_t index;
+	/** Output: Number of instructions executed, 0 if FRP table is
+	 * empty */
+	nveu32_t insn_cnt;
+};
+
+/**
+ * @brief osi_flow_spec - Flow steering rule
+ */
+struct osi_flow_spec {
+	/** Flow command OSI_FLOW_CMD_* */
+	nveu32_t cmd;
+	/** Flow ID, shares the FRP ID space */
+	nve32_t flow_id;
+	/** Bitmap of OSI_FLOW_* fields to match */
+	nveu32_t fields;
+	/** EtherType, inner EtherType for VLAN flows */
+	nveu16_t ethertype;
+	/** VLAN ID */
+	nveu16_t vlan_id;
+	/** IPv4 source address, network byte order */
+	nveu8_t ip4_src[4];
+	/** IPv4 destination address, network byte order */
+	nveu8_t ip4_dst[4];
+	/** IPv4 protocol */
+	nveu8_t ip4_proto;
+	/** L4 source port */
+	nveu16_t l4_src;
+	/** L4 destination port */
+	nveu16_t l4_dst;
+	/** Target DMA channel */
+	nveu32_t dma_chan;
+};
+
+/**
+ * @brief osi_l2_addr_list - L2 DA filter address list
+ */
+struct osi_l2_addr_list {
+	/** First perfect filter index owned by the list, indexes below
+	 * are left untouched */
+	nveu32_t start_idx;
+	/** DMA channel for perfect filter matches, needs DCS enabled.
+	 * OSI_CHAN_ANY leaves matches on default RX queue routing */
+	nveu32_t dma_chan;
+	/** Number of addresses in addr, max OSI_MAX_L2_ADDR_LIST */
+	nveu32_t count;
+	/** count * OSI_ETH_ALEN bytes of addresses */
+	const nveu8_t *addr;
+	/** Output: Number of addresses placed in hash filter */
+	nveu32_t hash_cnt;
+};
+
+/**
+ * @brief osi_vlan_list - VLAN ID list
+ */
+struct osi_vlan_list {
+	/** OSI_VLAN_ACTION_ADD or OSI_VLAN_ACTION_DEL */
+	nveu32_t action;
+	/** Number of VLAN IDs in vid, max VLAN_NUM_VID */
+	nveu32_t count;
+	/** VLAN IDs */
+	const nveu16_t *vid;
+};
+
+/**
+ * @brief osi_rss_rebalance - RSS table rebalancing request
+ */
+struct osi_rss_rebalance {
+	/** RX packets per queue since last request, indexed by RSS table
+	 * value, e.g. q_rx_pkt_n deltas from DMA stats */
+	nveu64_t q_rx_pkt[OSI_MGBE_MAX_NUM_QUEUES];
+	/** Rebalance only while the busiest queue load exceeds the mean
+	 * by more than this percentage, max OSI_RSS_REBAL_MAX_PCT */
+	nveu32_t imbalance_pct;
+	/** Max buckets to move, 0 for OSI_RSS_REBAL_MOVES */
+	nveu32_t max_moves;
+	/** Output: Number of buckets moved */
+	nveu32_t moved;
+};
+
+/**
+ * @brief osi_rss_hash - SW RSS hash of a flow
+ */
+struct osi_rss_hash {
+	/** OSI_RSS_IPV4 or OSI_RSS_IPV6 */
+	nveu32_t ip_ver;
+	/** IP protocol, ports are hashed for OSI_RSS_L4_TCP/OSI_RSS_L4_UDP */
+	nveu32_t l4_proto;
+	/** Source IP address, network byte order, IPv4 uses first 4 bytes */
+	nveu8_t src_ip[16];
+	/** Destination IP address, network byte order */
+	nveu8_t dst_ip[16];
+	/** L4 source port */
+	nveu16_t src_port;
+	/** L4 destination port */
+	nveu16_t dst_port;
+	/** Output: RSS hash as reported in Rx descriptor */
+	nveu32_t hash;
+	/** Output: OSI_ENABLE if flow is hashed per rss.hash_fields, else
+	 * hash, index and queue are not valid */
+	nveu32_t hashed;
+	/** Output: OSI_ENABLE if L4 ports were hashed */
+	nveu32_t l4;
+	/** Output: RSS table index */
+	nveu32_t index;
+	/** Output: RSS table entry at index */
+	nveu32_t queue;
+};
+
+/**
+ * @brief osi_rxq_remap - MTL RX queue to DMA channel and priority mapping
+ */
+struct osi_rxq_remap {
+	/** MTL RX queue index, one of osi_core->mtl_queues[] */
+	nveu32_t rxq;
+	/** DMA channel to route rxq to, OSI_CHAN_ANY to select it per
+	 * packet from the DA/flow filters (dynamic DMA channel selection) */
+	nveu32_t dma_chan;
+	/** Bitmap of VLAN user priorities steered to rxq, 0 for none.
+	 * Valid for rxq less than OSI_EQOS_MAX_NUM_QUEUES only */
+	nveu32_t prio;
+};
+
+/**
+ * @brief osi_est_plan_tc - Traffic class requirements and result of
+ * EST planning
+ */
+struct osi_est_plan_tc {
+	/** Bandwidth to reserve in permille of link rate, 0 for none */
+	nveu32_t bw;
+	/** Max latency in ns, 0 for no bound. A class with neither bw nor
+	 * max_lat_ns set is best effort */
+	nveu32_t max_lat_ns;
+	/** Output: Gate window per cycle in ns, exclusive to the class
+	 * except for best effort classes which share theirs */
+	nveu32_t window_ns;
+	/** Output: Worst case latency in ns, longest wait for the gate to
+	 * open plus transmission time of a max size frame. Queueing behind
+	 * frames of the same class is not included */
+	nveu32_t lat_ns;
+};
+
+/**
+ * @brief osi_est_plan - EST schedule planning from traffic class
+ * requirements
+ */
+struct osi_est_plan {
+	/** Link speed in Mbps, OSI_SPEED_* */
+	nveu32_t speed;
+	/** Cycle time in ns, 0 for the tightest latency bound or
+	 * OSI_EST_PLAN_DFLT_CYCLE_NS without one */
+	nveu32_t cycle_ns;
+	/** Number of traffic classes in tc[], max OSI_MAX_TC_NUM */
+	nveu32_t num_tc;
+	/** Per traffic class requirements and results */
+	struct osi_est_plan_tc tc[OSI_MAX_TC_NUM];
+	/** OSI_ENABLE to program the GCL as OSI_CMD_CONFIG_EST does */
+	nveu32_t apply;
+};
+
+/**
+ * @brief osi_cbs_queue - Bandwidth reservation of a credit based shaper
+ * queue
+ */
+struct osi_cbs_queue {
+	/** TX queue index, 1 to max MTL queues - 1 */
+	nveu32_t qindex;
+	/** Traffic class of the queue, 1 to OSI_MAX_TC_NUM - 1. Used for
+	 * MGBE only where CBS is per traffic class */
+	nveu32_t tcindex;
+	/** Bandwidth to reserve in kbps, 0 to disable CBS on the queue */
+	nveu32_t idle_kbps;
+	/** Max frame size of the queue in bytes, 0 for MTU plus L2
+	 * overhead */
+	nveu32_t max_frame;
+};
+
+/**
+ * @brief osi_cbs_config - Credit based shaper configuration of all AVB
+ * queues
+ */
+struct osi_cbs_config {
+	/** Link speed in Mbps, OSI_SPEED_*. 0 for the speed last set with
+	 * OSI_CMD_SET_SPEED. Credits are derived again on each speed
+	 * change */
+	nveu32_t speed;
+	/** Max total reservation in permille of link rate, 0 for
+	 * OSI_CBS_DFLT_MAX_BW */
+	nveu32_t max_bw;
+	/** Number of queues in q[] */
+	nveu32_t num_q;
+	/** Per queue reservations, in decreasing scheduling priority */
+	struct osi_cbs_queue q[OSI_MGBE_MAX_NUM_QUEUES];
+};
+
+/**
+ * @brief osi_pfc_config - 802.1Qbb priority flow control configuration
+ */
+struct osi_pfc_config {
+	/** Bitmap of VLAN priorities with PFC enabled. 0 disables PFC and
+	 * restores link level pause as set with OSI_CMD_FLOW_CTRL. RX
+	 * queues are found from rxq_prio, which is programmed at MAC init
+	 * when DCS is disabled, else through OSI_CMD_RXQ_REMAP */
+	nveu32_t prio_mask;
+	/** Pause time in 512 bit time quanta sent for a priority, 0 for
+	 * 0xFFFF */
+	nveu32_t pause_quanta;
+	/** Bitmap of priorities whose received PFC frames pause each TX
+	 * queue (EQOS) or traffic class (MGBE), 0 keeps the current one */
+	nveu32_t tx_prio[OSI_MAX_TC_NUM];
+	/** Per RX queue fill level in bytes below full to send pause at,
+	 * a multiple of 512 from 1536 to 32768. 0 keeps the current one */
+	nveu32_t rfa[OSI_MGBE_MAX_NUM_QUEUES];
+	/** Per RX queue fill level in bytes below full to resume at, not
+	 * less than rfa. Same range as rfa, 0 keeps the current one */
+	nveu32_t rfd[OSI_MGBE_MAX_NUM_QUEUES];
+};
+#endif /* !OSI_STRIPPED_LIB */
+
 /**
  * @brief Core time stamp data strcuture
  */
@@ -1160,6 +1515,28 @@ struct osi_ioctl {
 	struct osi_pto_config pto_config;
 	/** RXQ route structure */
 	struct osi_rxq_route rxq_route;
+	/** Flexible PPS output configuration */
+	struct osi_pps_config pps_config;
+	/** FRP frame evaluation */
+	struct osi_frp_eval frp_eval;
+	/** Flow steering rule */
+	struct osi_flow_spec flow_spec;
+	/** L2 DA filter address list */
+	struct osi_l2_addr_list l2_addr_list;
+	/** VLAN ID list */
+	struct osi_vlan_list vlan_list;
+	/** RSS table rebalancing */
+	struct osi_rss_rebalance rss_rebal;
+	/** SW RSS hash */
+	struct osi_rss_hash rss_hash;
+	/** RX queue remapping */
+	struct osi_rxq_remap rxq_remap;
+	/** EST schedule planning */
+	struct osi_est_plan est_plan;
+	/** CBS configuration of all AVB queues */
+	struct osi_cbs_config cbs;
+	/** PFC configuration */
+	struct osi_pfc_config pfc;
 #endif /* !OSI_STRIPPED_LIB */
 	/** FRP structure */
 	struct osi_core_frp_cmd frp_cmd;
@@ -1325,15 +1702,18 @@ struct osi_core_priv_data {
 	 * Value stored in MHz
 	 */
 	nveu32_t csr_clk_speed;
+	/** Bitmap of HW VLAN filters in use */
 	nveu64_t vf_bitmap;
-	/** Array to maintain VLAN filters */
+	/** VLAN ID of each HW VLAN filter */
 	nveu16_t vid[VLAN_NUM_VID];
-	/** Count of number of VLAN filters in vid array */
+	/** Count of number of VLAN IDs in VLAN filter set */
 	nveu16_t vlan_filter_cnt;
 	/** RSS core structure */
 	struct osi_core_rss rss;
 	/** DT entry to enable(1) or disable(0) pause frame support */
 	nveu32_t pause_frames;
+	/** Per MTL queue traffic profile, applied at osi_hw_core_init() */
+	struct osi_mtl_q_profile mtl_q_prof[OSI_MGBE_MAX_NUM_QUEUES];
 #endif
 	/** Residual queue valid with FPE support */
 	nveu32_t residual_queue;
@@ -1680,6 +2060,51 @@ nve32_t osi_init_core_ops(struct osi_core_priv_data *const osi_core);
  *	frp_cmd - FRP command parameter
  *  - OSI_CMD_CONFIG_RSS
  *	Configure RSS
+ *  - OSI_CMD_CONFIG_PPS
+ *	Start/stop flexible PPS output pulse train
+ *	pps_config - PPS output configuration structure
+ *  - OSI_CMD_FRP_EVAL
+ *	Run a frame through the program compiled from FRP table in SW, no
+ *	HW access, not supported over IVC as frame is passed by pointer
+ *	frp_eval - FRP frame evaluation structure
+ *  - OSI_CMD_FLOW_STEER
+ *	Add, delete or get a flow steering rule built on FRP
+ *	flow_spec - Flow steering rule structure
+ *  - OSI_CMD_L2_ADDR_LIST
+ *	Replace L2 DA filter address list, overflow goes to hash filter,
+ *	not supported over IVC as addresses are passed by pointer
+ *	l2_addr_list - L2 address list structure
+ *  - OSI_CMD_VLAN_LIST
+ *	Add or delete a list of VLAN IDs with a single HW filter update,
+ *	not supported over IVC as VLAN IDs are passed by pointer
+ *	vlan_list - VLAN ID list structure
+ *  - OSI_CMD_RSS_REBALANCE
+ *	Move RSS table buckets from busy to idle queues
+ *	rss_rebal - RSS rebalancing structure
+ *  - OSI_CMD_RSS_HASH
+ *	Compute RSS hash and queue of a flow in SW, no HW access
+ *	rss_hash - SW RSS hash structure
+ *  - OSI_CMD_RSS_UPDATE
+ *	Write only the selected parts of osi_core->rss to HW
+ *	arg1_u32 - OSI_RSS_UPD_* bits
+ *  - OSI_CMD_RXQ_REMAP
+ *	Remap an RX queue to a DMA channel and priorities at runtime
+ *	rxq_remap - RX queue remapping structure
+ *  - OSI_CMD_EST_WAIT_SWAP
+ *	Wait for HW to switch to the GCL last set with OSI_CMD_CONFIG_EST
+ *	arg1_u32 - Time to wait in ms, 0 to only check. At most one cycle
+ *	time of the programmed GCLs plus 10 ms, rounded up to ms
+ *  - OSI_CMD_EST_PLAN
+ *	Generate a GCL from per traffic class bandwidth and latency
+ *	est_plan - EST schedule planning structure
+ *	est - Output: EST configuration, base time left 0
+ *  - OSI_CMD_CONFIG_CBS
+ *	Derive and program CBS credits of all AVB queues from bandwidth
+ *	cbs - CBS configuration structure
+ *  - OSI_CMD_CONFIG_PFC
+ *	Configure per priority flow control, pause quanta and RX queue
+ *	flow control thresholds
+ *	pfc - PFC configuration structure
  *  - OSI_CMD_CONFIG_EST
  *	Configure EST registers and GCL to hw
  *	est - EST configuration structure
@@ -126,6 +126,8 @@
 #ifndef OSI_STRIPPED_LIB
 #define OSI_PKT_CX_RSS			OSI_BIT(5)
 #endif /* !OSI_STRIPPED_LIB */
+/** PTP Sync packet to be sent in one-step mode irrespective of ptp_flag */
+#define OSI_PKT_CX_ONESTEP_SYNC		OSI_BIT(6)
 /** Valid packet */
 #define OSI_PKT_CX_VALID		OSI_BIT(10)
 /** Update Packet Length in Tx Desc3 */
@@ -431,7 +433,8 @@ struct osi_tx_pkt_cx {
 	nveu32_t flags;
 	/** Stores the VLAN tag ID */
 	nveu32_t vtag_id;
-	/** Descriptor count */
+	/** Descriptor count, including one context descriptor if the
+	 * packet needs one, see osi_hw_transmit() */
 	nveu32_t desc_cnt;
 	/** Max. segment size for TSO/USO/GSO/LSO packet */
 	nveu32_t mss;
@@ -509,6 +512,10 @@ struct osi_xtra_dma_stat_counters {
 	nveu64_t tx_vlan_pkt_n;
 	/** Total number of TSO packet count */
 	nveu64_t tx_tso_pkt_n;
+	/** Per Q one-step PTP Sync TX packet count, packets flagged with
+	 * OSI_PKT_CX_ONESTEP_SYNC or PTP packets sent in one-step master
+	 * mode */
+	nveu64_t q_tx_onestep_pkt_n[OSI_MGBE_MAX_NUM_QUEUES];
 };
 #endif /* !OSI_STRIPPED_LIB */
 
@@ -772,8 +779,14 @@ nve32_t osi_set_rx_buf_len(struct osi_dma_priv_data *osi_dma);
  *    OSI_PKT_CX_CSUM                 OSI_BIT(1)
  *    OSI_PKT_CX_TSO                  OSI_BIT(2)
  *    OSI_PKT_CX_PTP                  OSI_BIT(3)
+ *    OSI_PKT_CX_ONESTEP_SYNC         OSI_BIT(6) along with OSI_PKT_CX_PTP
  *  - tx_pkt_cx->desc_cnt need to be populated which holds the number
- *    of swcx descriptors allocated for that packet
+ *    of swcx descriptors allocated for that packet. It includes one
+ *    context descriptor if OSI_PKT_CX_VLAN, OSI_PKT_CX_TSO or
+ *    OSI_PKT_CX_PTP is set. On EQOS with OSI_PTP_SYNC_TWOSTEP set in
+ *    ptp_flag, OSI_PKT_CX_PTP alone takes no context descriptor, while
+ *    OSI_PKT_CX_PTP with OSI_PKT_CX_ONESTEP_SYNC takes one, so a
+ *    one-step Sync needs one more descriptor than a two-step one
  *  - tx_swcx structure need to be filled for per packet with the
  *    buffer len, DMA mapped address of buffer for each descriptor
  *    consumed by the packet
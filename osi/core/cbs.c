@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef OSI_STRIPPED_LIB
+#include "../osi/common/common.h"
+#include "core_common.h"
+#include "cbs.h"
+
+/**
+ * @brief cbs_port_rate - Bits the MAC transmits per clock cycle.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] speed: Link speed in Mbps.
+ *
+ * @retval Bits per cycle, 0 if the MAC doesn't support the speed
+ */
+static nveu32_t cbs_port_rate(const struct osi_core_priv_data *const osi_core,
+			      nveu32_t speed)
+{
+	nveu32_t ptr = 0U;
+
+	switch ((nve32_t)speed) {
+	case OSI_SPEED_10:
+	case OSI_SPEED_100:
+		ptr = (osi_core->mac == OSI_MAC_HW_EQOS) ? 4U : 0U;
+		break;
+	case OSI_SPEED_1000:
+		ptr = (osi_core->mac == OSI_MAC_HW_EQOS) ? 8U : 0U;
+		break;
+	case OSI_SPEED_2500:
+		ptr = (osi_core->mac == OSI_MAC_HW_MGBE) ? 8U : 0U;
+		break;
+	case OSI_SPEED_5000:
+	case OSI_SPEED_10000:
+		ptr = (osi_core->mac == OSI_MAC_HW_MGBE) ? 32U : 0U;
+		break;
+	default:
+		/* Not supported */
+		break;
+	}
+
+	return ptr;
+}
+
+/**
+ * @brief cbs_div_up - Divide rounding up.
+ *
+ * @param[in] n: Dividend.
+ * @param[in] d: Divisor, non zero.
+ *
+ * @retval Quotient rounded up
+ */
+static inline nveu64_t cbs_div_up(nveu64_t n, nveu64_t d)
+{
+	return (n + d - 1U) / d;
+}
+
+/**
+ * @brief cbs_validate - Validate CBS configuration against a link rate.
+ *
+ * Algorithm: Check queue and TC indexes are in range and unique, and
+ *	the total reservation is within max_bw of the link rate.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] cbs: CBS configuration.
+ * @param[in] rate: Link rate in kbps.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t cbs_validate(struct osi_core_priv_data *const osi_core,
+			    const struct osi_cbs_config *const cbs,
+			    nveu64_t rate)
+{
+	const nveu32_t max_q[2] = { OSI_EQOS_MAX_NUM_QUEUES,
+				    OSI_MGBE_MAX_NUM_QUEUES };
+	const struct osi_cbs_queue *q;
+	nveu64_t sum = 0U;
+	nveu32_t max_bw = (cbs->max_bw == 0U) ? OSI_CBS_DFLT_MAX_BW :
+			  cbs->max_bw;
+	nveu32_t q_mask = 0U, tc_mask = 0U;
+	nveu32_t i;
+	nve32_t ret = -1;
+
+	if ((cbs->num_q > OSI_MGBE_MAX_NUM_QUEUES) ||
+	    (max_bw > OSI_CBS_BW_MAX)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid CBS num_q/max_bw\n",
+			     (nveul64_t)cbs->num_q);
+		goto fail;
+	}
+
+	for (i = 0U; i < cbs->num_q; i++) {
+		q = &cbs->q[i];
+		if ((q->qindex == 0U) || (q->qindex >= max_q[osi_core->mac]) ||
+		    ((q_mask & OSI_BIT(q->qindex)) != 0U)) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "Invalid CBS queue\n",
+				     (nveul64_t)q->qindex);
+			goto fail;
+		}
+		q_mask |= OSI_BIT(q->qindex);
+
+		/* MGBE shapes per TC, so queues can't share one */
+		if ((osi_core->mac == OSI_MAC_HW_MGBE) &&
+		    ((q->tcindex == 0U) || (q->tcindex >= OSI_MAX_TC_NUM) ||
+		     ((tc_mask & OSI_BIT(q->tcindex)) != 0U))) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "Invalid CBS TC\n",
+				     (nveul64_t)q->tcindex);
+			goto fail;
+		}
+		tc_mask |= OSI_BIT(q->tcindex);
+
+		sum += q->idle_kbps;
+	}
+
+	if ((sum * OSI_CBS_BW_MAX) > (rate * max_bw)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "CBS reservation exceeds link rate\n",
+			     (nveul64_t)sum);
+		goto fail;
+	}
+
+	ret = 0;
+fail:
+	return ret;
+}
+
+/**
+ * @brief cbs_derive - Derive slopes and credits of all CBS queues.
+ *
+ * Algorithm: Per IEEE 802.1Q Annex L, generalized to any number of
+ *	classes:
+ *	1) Idle slope is the reserved share of bits per cycle rounded up,
+ *	   send slope is the rest of the port rate.
+ *	2) Hi credit is the credit gained while the largest lower priority
+ *	   frame blocks the queue, at the rate left over by higher
+ *	   priority queues, plus while one max frame of each higher
+ *	   priority queue is sent.
+ *	3) Low credit is the credit lost sending one max frame of the queue.
+ *	Credits are rounded away from zero so shaping never undershoots
+ *	the reservation.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] cbs: Validated CBS configuration.
+ * @param[in] ptr: Port transmit rate in bits per cycle.
+ * @param[in] rate: Link rate in kbps.
+ * @param[out] avb: AVB configuration per entry of cbs->q[].
+ */
+static void cbs_derive(const struct osi_core_priv_data *const osi_core,
+		       const struct osi_cbs_config *const cbs,
+		       nveu64_t ptr, nveu64_t rate,
+		       struct osi_core_avb_algorithm *const avb)
+{
+	const nveu64_t scale = 8U * CBS_CREDIT_SCALE;
+	const struct osi_cbs_queue *q;
+	nveu64_t mtu = osi_core->mtu;
+	nveu64_t dflt, frame, intf, idle, hi, lo;
+	nveu64_t s_high = 0U, f_high = 0U;
+	nveu32_t i, j;
+
+	if ((mtu < OSI_DFLT_MTU_SIZE) || (mtu > OSI_MAX_MTU_SIZE)) {
+		mtu = OSI_DFLT_MTU_SIZE;
+	}
+	dflt = mtu + MTL_FRAME_OVERHEAD;
+
+	for (i = 0U; i < cbs->num_q; i++) {
+		q = &cbs->q[i];
+		osi_memset(&avb[i], 0U, sizeof(struct osi_core_avb_algorithm));
+		avb[i].qindex = q->qindex;
+		avb[i].tcindex = q->tcindex;
+		if (q->idle_kbps == 0U) {
+			avb[i].oper_mode = OSI_MTL_QUEUE_ENABLE;
+			avb[i].algo = OSI_MTL_TXQ_AVALG_SP;
+			continue;
+		}
+
+		frame = (q->max_frame == 0U) ? dflt : q->max_frame;
+		/* Best effort traffic can always interfere with MTU frames */
+		intf = dflt;
+		for (j = i + 1U; j < cbs->num_q; j++) {
+			if (cbs->q[j].max_frame > intf) {
+				intf = cbs->q[j].max_frame;
+			}
+		}
+
+		idle = cbs_div_up(q->idle_kbps * ptr * CBS_CREDIT_SCALE, rate);
+		hi = cbs_div_up(q->idle_kbps * scale * intf, rate - s_high) +
+		     cbs_div_up(q->idle_kbps * scale * f_high, rate);
+		lo = cbs_div_up(frame * scale * (rate - q->idle_kbps), rate);
+
+		avb[i].oper_mode = OSI_MTL_QUEUE_AVB;
+		avb[i].algo = OSI_MTL_TXQ_AVALG_CBS;
+		avb[i].idle_slope = (nveu32_t)idle;
+		avb[i].send_slope = (nveu32_t)((ptr * CBS_CREDIT_SCALE) - idle);
+		avb[i].hi_credit = (nveu32_t)hi;
+		/* Two's complement, HW takes the low credit as negative */
+		avb[i].low_credit = (nveu32_t)(~lo + 1U);
+
+		s_high += q->idle_kbps;
+		f_high += frame;
+	}
+}
+
+/**
+ * @brief cbs_apply - Derive and program CBS of all queues for a speed.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] cbs: CBS configuration.
+ * @param[in] speed: Link speed in Mbps.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t cbs_apply(struct osi_core_priv_data *const osi_core,
+			 const struct osi_cbs_config *const cbs,
+			 nveu32_t speed)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct osi_core_avb_algorithm avb[OSI_MGBE_MAX_NUM_QUEUES];
+	nveu64_t rate = (nveu64_t)speed * 1000U;
+	nveu32_t ptr = cbs_port_rate(osi_core, speed);
+	nveu32_t i;
+	nve32_t ret = -1;
+
+	if (ptr == 0U) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid CBS link speed\n", (nveul64_t)speed);
+		goto fail;
+	}
+
+	if (cbs_validate(osi_core, cbs, rate) < 0) {
+		goto fail;
+	}
+
+	cbs_derive(osi_core, cbs, ptr, rate, avb);
+
+	/* Don't program any queue unless all of them are in range */
+	for (i = 0U; i < cbs->num_q; i++) {
+		if ((avb[i].algo == OSI_MTL_TXQ_AVALG_CBS) &&
+		    (hw_validate_avb_input(osi_core, &avb[i]) < 0)) {
+			goto fail;
+		}
+	}
+
+	for (i = 0U; i < cbs->num_q; i++) {
+		if (l_core->ops_p->set_avb_algorithm(osi_core, &avb[i]) < 0) {
+			goto fail;
+		}
+
+		(void)osi_memcpy(&l_core->cfg.avb[avb[i].qindex].avb_info,
+				 &avb[i], sizeof(struct osi_core_avb_algorithm));
+		l_core->cfg.avb[avb[i].qindex].used = OSI_ENABLE;
+		l_core->cfg.flags |= DYNAMIC_CFG_AVB;
+	}
+
+	ret = 0;
+fail:
+	return ret;
+}
+
+nve32_t config_cbs(struct osi_core_priv_data *const osi_core,
+		   const struct osi_cbs_config *const cbs)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t speed = (cbs->speed == 0U) ? l_core->link_speed : cbs->speed;
+	nve32_t ret;
+
+	ret = cbs_apply(osi_core, cbs, speed);
+	if (ret == 0) {
+		(void)osi_memcpy(&l_core->cbs, cbs,
+				 sizeof(struct osi_cbs_config));
+		l_core->cbs_valid = OSI_ENABLE;
+	}
+
+	return ret;
+}
+
+void cbs_speed_change(struct osi_core_priv_data *const osi_core,
+		      const nveu32_t speed)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct osi_core_avb_algorithm avb;
+	nveu32_t i;
+
+	l_core->link_speed = speed;
+	if ((l_core->cbs_valid != OSI_ENABLE) ||
+	    (cbs_apply(osi_core, &l_core->cbs, speed) == 0)) {
+		goto done;
+	}
+
+	/* Credits of the old speed would over or under shape, so don't
+	 * leave them in place */
+	OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+		     "CBS disabled until reservations fit link rate\n",
+		     (nveul64_t)speed);
+	for (i = 0U; i < l_core->cbs.num_q; i++) {
+		osi_memset(&avb, 0U, sizeof(struct osi_core_avb_algorithm));
+		avb.qindex = l_core->cbs.q[i].qindex;
+		avb.tcindex = l_core->cbs.q[i].tcindex;
+		avb.oper_mode = OSI_MTL_QUEUE_ENABLE;
+		avb.algo = OSI_MTL_TXQ_AVALG_SP;
+		(void)l_core->ops_p->set_avb_algorithm(osi_core, &avb);
+		(void)osi_memcpy(&l_core->cfg.avb[avb.qindex].avb_info, &avb,
+				 sizeof(struct osi_core_avb_algorithm));
+	}
+done:
+	return;
+}
+#endif /* !OSI_STRIPPED_LIB */
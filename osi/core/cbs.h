@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef CBS_H
+#define CBS_H
+
+#include <osi_common.h>
+#include <osi_core.h>
+#include "core_local.h"
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @addtogroup CBS Credit based shaper defines
+ *
+ * @brief Credit registers hold bits scaled by CBS_CREDIT_SCALE, slopes
+ *	are in bits per MAC transmit clock cycle scaled the same way
+ * @{
+ */
+#define CBS_CREDIT_SCALE	1024U
+/** @} */
+
+/**
+ * @brief config_cbs - Derive and program CBS of all AVB queues.
+ *
+ * Algorithm: Derive idle/send slopes and hi/low credits of each queue
+ *	from its reservation and the link speed, following IEEE 802.1Q
+ *	Annex L with queues in the order given as scheduling priority.
+ *	Validate all queues and the total reservation before programming
+ *	any of them. Configuration is kept to derive the credits again on
+ *	speed change.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] cbs: CBS configuration.
+ *
+ * @note MAC should be init and started. see osi_start_mac()
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+nve32_t config_cbs(struct osi_core_priv_data *const osi_core,
+		   const struct osi_cbs_config *const cbs);
+
+/**
+ * @brief cbs_speed_change - Derive CBS credits again for a new link speed.
+ *
+ * Algorithm: Record the speed. If CBS is configured, program the credits
+ *	for the new speed. If the reservations don't fit the new link rate,
+ *	disable CBS on the queues until a speed they fit is set.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] speed: New link speed in Mbps.
+ */
+void cbs_speed_change(struct osi_core_priv_data *const osi_core,
+		      const nveu32_t speed);
+#endif /* !OSI_STRIPPED_LIB */
+#endif /* CBS_H */
@@ -26,6 +26,9 @@
 #include "eqos_core.h"
 #include "xpcs.h"
 #include "macsec.h"
+#ifndef OSI_STRIPPED_LIB
+#include "cbs.h"
+#endif /* !OSI_STRIPPED_LIB */
 
 static inline nve32_t poll_check(struct osi_core_priv_data *const osi_core, nveu8_t *addr,
 				 nveu32_t bit_check, nveu32_t *value)
@@ -131,12 +134,78 @@ fail:
 	return ret;
 }
 
+/**
+ * @brief fpe_hadv - Hold advance for the FPE fragment size and link speed.
+ *
+ * Algorithm: Time to send a min size fragment with its overhead, so a
+ *	fragment in flight is done when a gate for express traffic opens.
+ *	MTL_FPE_ADV_HADV_VAL if link speed isn't known.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @retval Hold advance in ns
+ */
+static nveu32_t fpe_hadv(struct osi_core_priv_data *const osi_core)
+{
+	nveu32_t hadv = MTL_FPE_ADV_HADV_VAL;
+#ifndef OSI_STRIPPED_LIB
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu64_t bytes, ns;
+
+	if (l_core->link_speed != 0U) {
+		bytes = ((nveu64_t)l_core->fpe_afsz + 1U) * MTL_FPE_FRAG_UNIT;
+		bytes += MTL_FPE_FRAG_OVERHEAD;
+		ns = ((bytes * 8000U) + l_core->link_speed - 1U) /
+		     l_core->link_speed;
+		hadv = (ns > MTL_FPE_ADV_HADV_MASK) ? MTL_FPE_ADV_HADV_MASK :
+		       (nveu32_t)ns;
+	}
+#else
+	(void)osi_core;
+#endif /* !OSI_STRIPPED_LIB */
+
+	return hadv;
+}
+
+/**
+ * @brief fpe_set_frag - Program FPE fragment size and hold advance.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] afsz: Additional fragment size, in 64 byte units.
+ */
+static void fpe_set_frag(struct osi_core_priv_data *const osi_core,
+			 nveu32_t afsz)
+{
+	const nveu32_t MTL_FPE_CTS[MAX_MAC_IP_TYPES] = {EQOS_MTL_FPE_CTS,
+						MGBE_MTL_FPE_CTS};
+	const nveu32_t MTL_FPE_ADV[MAX_MAC_IP_TYPES] = {EQOS_MTL_FPE_ADV,
+						MGBE_MTL_FPE_ADV};
+	nveu32_t val;
+
+	val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
+			 MTL_FPE_CTS[osi_core->mac]);
+	val &= ~MTL_FPE_CTS_AFSZ;
+	val |= (afsz & MTL_FPE_CTS_AFSZ);
+	osi_writela(osi_core, val, (nveu8_t *)osi_core->base +
+		    MTL_FPE_CTS[osi_core->mac]);
+
+	val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
+			 MTL_FPE_ADV[osi_core->mac]);
+	val &= ~MTL_FPE_ADV_HADV_MASK;
+	val |= fpe_hadv(osi_core);
+	osi_writela(osi_core, val, (nveu8_t *)osi_core->base +
+		    MTL_FPE_ADV[osi_core->mac]);
+}
+
 nve32_t hw_set_speed(struct osi_core_priv_data *const osi_core, const nve32_t speed)
 {
 	nveu32_t  value;
 	nve32_t  ret = 0;
 	void *base = osi_core->base;
 	const nveu32_t mac_mcr[2] = { EQOS_MAC_MCR, MGBE_MAC_TMCR };
+#ifndef OSI_STRIPPED_LIB
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+#endif /* !OSI_STRIPPED_LIB */
 
 	if (((osi_core->mac == OSI_MAC_HW_EQOS) && (speed > OSI_SPEED_1000)) ||
 	    ((osi_core->mac == OSI_MAC_HW_MGBE) && ((speed < OSI_SPEED_2500) ||
@@ -194,6 +263,14 @@ nve32_t hw_set_speed(struct osi_core_priv_data *const osi_core, const nve32_t sp
 			goto fail;
 		}
 	}
+
+#ifndef OSI_STRIPPED_LIB
+	/* CBS credits and FPE hold advance depend on link rate */
+	cbs_speed_change(osi_core, (nveu32_t)speed);
+	if (l_core->fpe_enabled == OSI_ENABLE) {
+		fpe_set_frag(osi_core, l_core->fpe_afsz);
+	}
+#endif /* !OSI_STRIPPED_LIB */
 fail:
 	return ret;
 }
@@ -364,6 +441,12 @@ nve32_t hw_config_addend(struct osi_core_priv_data *const osi_core,
 
 	ret = poll_check(osi_core, ((nveu8_t *)addr + mac_tscr[osi_core->mac]),
 			 MAC_TCR_TSADDREG, &mac_tcr);
+#ifndef OSI_STRIPPED_LIB
+	if (ret == 0) {
+		osi_core->stats.ptp_addend_writes =
+			osi_update_stats_counter(osi_core->stats.ptp_addend_writes, 1UL);
+	}
+#endif /* !OSI_STRIPPED_LIB */
 fail:
 	return ret;
 }
@@ -381,6 +464,7 @@ void hw_config_tscr(struct osi_core_priv_data *const osi_core, OSI_UNUSED const
 	nveu32_t i = 0U, temp = 0U;
 #endif /* !OSI_STRIPPED_LIB */
 	nveu32_t value = 0x0U;
+	nveu32_t flex = 0U;
 	const nveu32_t mac_tscr[2] = { EQOS_MAC_TCR, MGBE_MAC_TCR};
 	const nveu32_t mac_pps[2] = { EQOS_MAC_PPS_CTL, MGBE_MAC_PPS_CTL};
 
@@ -431,42 +515,791 @@ void hw_config_tscr(struct osi_core_priv_data *const osi_core, OSI_UNUSED const
 				break;
 			}
 		}
-	} else {
-		/* Disabling the MAC time stamping */
-		mac_tcr = OSI_DISABLE;
+	} else {
+		/* Disabling the MAC time stamping */
+		mac_tcr = OSI_DISABLE;
+	}
+#else
+	mac_tcr = (OSI_MAC_TCR_TSENA | OSI_MAC_TCR_TSCFUPDT | OSI_MAC_TCR_TSCTRLSSR
+		   | OSI_MAC_TCR_TSVER2ENA | OSI_MAC_TCR_TSIPENA | OSI_MAC_TCR_TSIPV6ENA |
+		   OSI_MAC_TCR_TSIPV4ENA | OSI_MAC_TCR_SNAPTYPSEL_1);
+#endif /* !OSI_STRIPPED_LIB */
+
+	osi_writela(osi_core, mac_tcr, ((nveu8_t *)addr + mac_tscr[osi_core->mac]));
+
+	value = osi_readla(osi_core, (nveu8_t *)addr + mac_pps[osi_core->mac]);
+#ifndef OSI_STRIPPED_LIB
+	/* In flexible mode PPSCTRL0 is the output 0 command, leave it */
+	flex = value & MAC_PPS_CTL_PPSEN0;
+#endif /* !OSI_STRIPPED_LIB */
+	if (flex == 0U) {
+		value &= ~MAC_PPS_CTL_PPSCTRL0;
+		if (l_core->pps_freq == OSI_ENABLE) {
+			value |= OSI_ENABLE;
+		}
+		osi_writela(osi_core, value, ((nveu8_t *)addr + mac_pps[osi_core->mac]));
+	}
+}
+
+/**
+ * @brief ptp_ssinc - Sub-second increment of the exact MAC used
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @retval PTP clock tick in nano seconds
+ */
+static nveu32_t ptp_ssinc(const struct osi_core_priv_data *const osi_core)
+{
+	const struct core_local *l_core = (const struct core_local *)(const void *)osi_core;
+	const nveu32_t ssinc[3] = {OSI_PTP_SSINC_4, OSI_PTP_SSINC_6, OSI_PTP_SSINC_4};
+
+	return ssinc[l_core->l_mac_ver];
+}
+
+void hw_config_ssir(struct osi_core_priv_data *const osi_core)
+{
+	nveu32_t val = 0U;
+	void *addr = osi_core->base;
+	const nveu32_t mac_ssir[2] = { EQOS_MAC_SSIR, MGBE_MAC_SSIR};
+
+	/* by default Fine method is enabled */
+	/* Fix the SSINC value based on Exact MAC used */
+	val = ptp_ssinc(osi_core);
+
+	val |= val << MAC_SSIR_SSINC_SHIFT;
+	/* update Sub-second Increment Value */
+	osi_writela(osi_core, val, ((nveu8_t *)addr + mac_ssir[osi_core->mac]));
+}
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief pps_schedule_start - Select start time for PPS pulse train
+ *
+ * Algorithm:
+ * - Read current MAC system time.
+ * - If requested start time is zero or not in future by at least one
+ *   second, move it to the next second boundary after that margin
+ *   keeping requested nano seconds as phase. This allows reprogramming
+ *   an output without stopping the MAC clock.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] pps: PPS output configuration.
+ * @param[out] sec: Start time seconds to program.
+ */
+static void pps_schedule_start(struct osi_core_priv_data *const osi_core,
+			       const struct osi_pps_config *const pps,
+			       nveu32_t *sec)
+{
+	nveu32_t cur_sec = 0U;
+	nveu32_t cur_nsec = 0U;
+
+	common_get_systime_from_mac(osi_core->base, osi_core->mac,
+				    &cur_sec, &cur_nsec);
+
+	*sec = pps->start_sec;
+	if ((cur_sec < (UINT_MAX - 2U)) && (pps->start_sec <= (cur_sec + 1U))) {
+		*sec = cur_sec + 2U;
+	}
+}
+
+/**
+ * @brief hw_config_l2_hash - Program L2 DA hash filter
+ *
+ * Algorithm:
+ * - Write MAC hash table registers which differ from old, all of them
+ *   if old is NULL.
+ * - Set HMC/HUC bits of MAC packet filter register as requested along with
+ *   HPF so perfect filter matches keep passing, clear them otherwise.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] htr: New hash table register values.
+ * @param[in] old: Hash table register values in HW, or NULL.
+ * @param[in] nregs: Number of hash table registers.
+ * @param[in] pfr_bits: MAC_PFR_HMC and/or MAC_PFR_HUC to enable.
+ */
+void hw_config_l2_hash(struct osi_core_priv_data *const osi_core,
+		       const nveu32_t *const htr, const nveu32_t *const old,
+		       nveu32_t nregs, nveu32_t pfr_bits)
+{
+	nveu8_t *base = (nveu8_t *)osi_core->base;
+	nveu32_t i, value, pfr;
+
+	for (i = 0U; i < nregs; i++) {
+		if ((old == OSI_NULL) || (old[i] != htr[i])) {
+			osi_writela(osi_core, htr[i], base + MAC_HTR_REG(i));
+		}
+	}
+
+	value = osi_readla(osi_core, base + MAC_PKT_FILTER_REG);
+	pfr = value & ~(MAC_PFR_HMC | MAC_PFR_HUC);
+	pfr |= (pfr_bits & (MAC_PFR_HMC | MAC_PFR_HUC));
+	if (pfr_bits != 0U) {
+		pfr |= MAC_PFR_HPF;
+	}
+
+	if (pfr != value) {
+		osi_writela(osi_core, pfr, base + MAC_PKT_FILTER_REG);
+	}
+}
+
+/**
+ * @brief hw_config_pps - Configure flexible PPS output
+ *
+ * Algorithm:
+ * - Validate PPS output index against HW capability.
+ * - If disable requested, issue immediate stop command.
+ * - Else convert period and width to PTP clock ticks, schedule start
+ *   time, program target time, interval and width registers and issue
+ *   start pulse train command.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] pps: PPS output configuration.
+ *
+ * @note PTP should be configured. see osi_ptp_configuration()
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+nve32_t hw_config_pps(struct osi_core_priv_data *const osi_core,
+		      const struct osi_pps_config *const pps)
+{
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu8_t *base = (nveu8_t *)osi_core->base;
+	const nveu32_t mac_pps[2] = { EQOS_MAC_PPS_CTL, MGBE_MAC_PPS_CTL };
+	const nveu32_t mac_ttsr[2] = { EQOS_MAC_PPS_TTSR(pps->idx),
+				       MGBE_MAC_PPS_TTSR(pps->idx) };
+	const nveu32_t mac_ttnsr[2] = { EQOS_MAC_PPS_TTNSR(pps->idx),
+					MGBE_MAC_PPS_TTNSR(pps->idx) };
+	const nveu32_t mac_interval[2] = { EQOS_MAC_PPS_INTERVAL(pps->idx),
+					   MGBE_MAC_PPS_INTERVAL(pps->idx) };
+	const nveu32_t mac_width[2] = { EQOS_MAC_PPS_WIDTH(pps->idx),
+					MGBE_MAC_PPS_WIDTH(pps->idx) };
+	nveu32_t shift, value, ttnsr = 0U;
+	nveu32_t interval, width, sec = 0U;
+	nve32_t ret = -1;
+
+	if ((pps->idx >= OSI_MAX_PPS_OUT) ||
+	    ((osi_core->hw_feature != OSI_NULL) &&
+	     (pps->idx >= osi_core->hw_feature->pps_out_num))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "PPS: invalid output index\n", (nveul64_t)pps->idx);
+		goto fail;
+	}
+
+	if ((pps->idx == 0U) && (l_core->pps_freq == OSI_ENABLE)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "PPS: output 0 used for fixed PPS\n", 0ULL);
+		goto fail;
+	}
+
+	shift = pps->idx * MAC_PPS_CTL_OUT_SHIFT;
+	value = osi_readla(osi_core, base + mac_pps[osi_core->mac]);
+	value &= ~(MAC_PPS_CTL_PPSCMD_MASK << shift);
+
+	if (pps->enable == OSI_DISABLE) {
+		value |= (MAC_PPS_CMD_STOP_IMMEDIATE << shift);
+		osi_writela(osi_core, value, base + mac_pps[osi_core->mac]);
+		if (pps->idx == 0U) {
+			/* Back to fixed mode output as set by hw_config_tscr() */
+			value &= ~(MAC_PPS_CTL_PPSEN0 | MAC_PPS_CTL_PPSCTRL0);
+			osi_writela(osi_core, value,
+				    base + mac_pps[osi_core->mac]);
+		}
+		ret = 0;
+		goto fail;
+	}
+
+	interval = pps->period_ns / ptp_ssinc(osi_core);
+	width = pps->width_ns / ptp_ssinc(osi_core);
+	if ((pps->start_nsec >= OSI_NSEC_PER_SEC) || (width == 0U) ||
+	    (pps->width_ns >= pps->period_ns) || (interval <= width)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "PPS: invalid period/width/start\n",
+			     (nveul64_t)pps->period_ns);
+		goto fail;
+	}
+
+	/* Target time registers can't be written while HW is using them */
+	ret = poll_check(osi_core, base + mac_ttnsr[osi_core->mac],
+			 MAC_PPS_TTNSR_TRGTBUSY, &ttnsr);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	pps_schedule_start(osi_core, pps, &sec);
+	osi_writela(osi_core, sec, base + mac_ttsr[osi_core->mac]);
+	osi_writela(osi_core, pps->start_nsec, base + mac_ttnsr[osi_core->mac]);
+	/* HW generates (value + 1) ticks for interval and width */
+	osi_writela(osi_core, interval - 1U, base + mac_interval[osi_core->mac]);
+	osi_writela(osi_core, width - 1U, base + mac_width[osi_core->mac]);
+
+	if (pps->idx == 0U) {
+		/* Output 0 works in flexible mode only with PPSEN0 set */
+		value |= MAC_PPS_CTL_PPSEN0;
+	}
+	value &= ~(MAC_PPS_CTL_TRGTMODSEL_MASK <<
+		   (shift + MAC_PPS_CTL_TRGTMODSEL_SHIFT));
+	value |= (MAC_PPS_CTL_TRGTMODSEL_PPS <<
+		  (shift + MAC_PPS_CTL_TRGTMODSEL_SHIFT));
+	value |= (MAC_PPS_CMD_START_TRAIN << shift);
+	osi_writela(osi_core, value, base + mac_pps[osi_core->mac]);
+
+fail:
+	return ret;
+}
+
+/**
+ * @brief mtl_fifo_thresh - Derive flow control thresholds of a RX FIFO
+ *
+ * Algorithm:
+ * - Activate flow control with a quarter of the FIFO left, bounded by
+ *   1.5KB and the largest threshold HW can encode (32KB).
+ * - Deactivate it once another eighth of the FIFO drained, provided that
+ *   still fits the FIFO and the encoding, else at the activate threshold.
+ *
+ * @param[in] rx_kb: RX FIFO size in KB.
+ * @param[out] rfa: RFA value, FIFO full minus (rfa + 2) * 512 bytes.
+ * @param[out] rfd: RFD value, same encoding as rfa.
+ */
+static void mtl_fifo_thresh(nveu32_t rx_kb, nveu32_t *rfa, nveu32_t *rfd)
+{
+	nveu32_t units = rx_kb * 2U;
+	nveu32_t on = units / 4U;
+	nveu32_t off;
+
+	if (on < MTL_FC_THRESH_MIN) {
+		on = MTL_FC_THRESH_MIN;
+	}
+	if (on > MTL_FC_THRESH_MAX) {
+		on = MTL_FC_THRESH_MAX;
+	}
+
+	off = on + (units / 8U);
+	if ((off > MTL_FC_THRESH_MAX) || (off >= units)) {
+		off = on;
+	}
+
+	*rfa = on - 2U;
+	*rfd = off - 2U;
+}
+
+/**
+ * @brief hw_plan_mtl_fifo - Partition MTL FIFOs from queue profiles
+ *
+ * Algorithm:
+ * - Validate osi_core->mtl_q_prof[] of the enabled MTL queues. If all of
+ *   them have OSI_MTL_Q_ROLE_DEFAULT keep the fixed per MAC layout.
+ * - Give every queue its role minimum, which is at least one MTU frame as
+ *   TX and RX run in store and forward mode. Latency and PTP queues stay at
+ *   the minimum, jumbo queues get room for two 9K frames in RX.
+ * - Split what is left of the per MAC TX and RX FIFO totals between the
+ *   bulk, jumbo and default role queues by weight, or between all queues
+ *   if there are none of them.
+ * - Derive RFA/RFD of each queue from its RX FIFO size.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @note Must be called before MTL queues are configured.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+nve32_t hw_plan_mtl_fifo(struct osi_core_priv_data *const osi_core)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	/* Same totals (KB) the fixed per MAC layouts distribute */
+	const nveu32_t rx_total[3] = { 40U, 64U, 192U };
+	const nveu32_t tx_total[3] = { 40U, 64U, 128U };
+	const nveu32_t role_min[OSI_MTL_Q_ROLE_MAX] = { 4U, 4U, 2U, 2U, 0U };
+	nveu32_t rx_kb[OSI_MGBE_MAX_NUM_QUEUES] = { 0U };
+	nveu32_t tx_kb[OSI_MGBE_MAX_NUM_QUEUES] = { 0U };
+	nveu32_t w[OSI_MGBE_MAX_NUM_QUEUES] = { 0U };
+	const struct osi_mtl_q_profile *prof;
+	nveu32_t mtu = osi_core->mtu;
+	nveu32_t frame_kb, jumbo_kb, qmin;
+	nveu32_t rx_left, tx_left, rx_extra, tx_extra;
+	nveu32_t wsum = 0U, first = OSI_MGBE_MAX_NUM_QUEUES;
+	nveu32_t i, q;
+	nve32_t ret = 0;
+
+	l_core->mtl_fifo_auto = OSI_DISABLE;
+
+	if (osi_core->num_mtl_queues > OSI_MGBE_MAX_NUM_QUEUES) {
+		ret = -1;
+		goto fail;
+	}
+
+	for (i = 0U; i < osi_core->num_mtl_queues; i++) {
+		q = osi_core->mtl_queues[i];
+		if (q >= OSI_MGBE_MAX_NUM_QUEUES) {
+			ret = -1;
+			goto fail;
+		}
+
+		prof = &osi_core->mtl_q_prof[q];
+		if ((prof->role >= OSI_MTL_Q_ROLE_MAX) ||
+		    (prof->weight > OSI_MTL_Q_WEIGHT_MAX)) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "Invalid MTL queue profile\n",
+				     (nveul64_t)q);
+			ret = -1;
+			goto fail;
+		}
+
+		if (prof->role != OSI_MTL_Q_ROLE_DEFAULT) {
+			l_core->mtl_fifo_auto = OSI_ENABLE;
+		}
+	}
+
+	if (l_core->mtl_fifo_auto == OSI_DISABLE) {
+		goto fail;
+	}
+
+	if ((mtu < OSI_DFLT_MTU_SIZE) || (mtu > OSI_MAX_MTU_SIZE)) {
+		mtu = OSI_DFLT_MTU_SIZE;
+	}
+	frame_kb = (mtu + MTL_FRAME_OVERHEAD + 1023U) / 1024U;
+	jumbo_kb = (((mtu > OSI_MTU_SIZE_9000) ? mtu : OSI_MTU_SIZE_9000) +
+		    MTL_FRAME_OVERHEAD + 1023U) / 1024U;
+
+	rx_left = rx_total[l_core->l_mac_ver];
+	tx_left = tx_total[l_core->l_mac_ver];
+	for (i = 0U; i < osi_core->num_mtl_queues; i++) {
+		q = osi_core->mtl_queues[i];
+		prof = &osi_core->mtl_q_prof[q];
+
+		qmin = (role_min[prof->role] > frame_kb) ?
+			role_min[prof->role] : frame_kb;
+		tx_kb[q] = qmin;
+		rx_kb[q] = qmin;
+		if (prof->role == OSI_MTL_Q_ROLE_JUMBO) {
+			tx_kb[q] = (jumbo_kb > qmin) ? jumbo_kb : qmin;
+			rx_kb[q] = tx_kb[q] * 2U;
+		}
+
+		if ((rx_kb[q] > rx_left) || (tx_kb[q] > tx_left)) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "MTL FIFO too small for queue profiles\n",
+				     (nveul64_t)q);
+			ret = -1;
+			goto fail;
+		}
+		rx_left -= rx_kb[q];
+		tx_left -= tx_kb[q];
+
+		if ((prof->role == OSI_MTL_Q_ROLE_DEFAULT) ||
+		    (prof->role == OSI_MTL_Q_ROLE_BULK) ||
+		    (prof->role == OSI_MTL_Q_ROLE_JUMBO)) {
+			w[q] = (prof->weight == 0U) ? 1U : prof->weight;
+			wsum += w[q];
+			if (first == OSI_MGBE_MAX_NUM_QUEUES) {
+				first = q;
+			}
+		}
+	}
+
+	if (wsum == 0U) {
+		for (i = 0U; i < osi_core->num_mtl_queues; i++) {
+			w[osi_core->mtl_queues[i]] = 1U;
+		}
+		wsum = osi_core->num_mtl_queues;
+		first = osi_core->mtl_queues[0];
+	}
+
+	rx_extra = rx_left;
+	tx_extra = tx_left;
+	for (i = 0U; i < osi_core->num_mtl_queues; i++) {
+		q = osi_core->mtl_queues[i];
+		rx_kb[q] += (rx_extra * w[q]) / wsum;
+		tx_kb[q] += (tx_extra * w[q]) / wsum;
+		rx_left -= (rx_extra * w[q]) / wsum;
+		tx_left -= (tx_extra * w[q]) / wsum;
+	}
+	/* Rounding remainder goes to the first weighted queue */
+	rx_kb[first] += rx_left;
+	tx_kb[first] += tx_left;
+
+	for (i = 0U; i < osi_core->num_mtl_queues; i++) {
+		q = osi_core->mtl_queues[i];
+		l_core->mtl_rx_fifo[q] = FIFO_SZ(rx_kb[q]);
+		l_core->mtl_tx_fifo[q] = FIFO_SZ(tx_kb[q]);
+		mtl_fifo_thresh(rx_kb[q], &l_core->mtl_rfa[q],
+				&l_core->mtl_rfd[q]);
+	}
+
+fail:
+	if (ret < 0) {
+		l_core->mtl_fifo_auto = OSI_DISABLE;
+	}
+	return ret;
+}
+
+/**
+ * @brief rxq_remap_validate - Validate RX queue remapping request
+ *
+ * Algorithm:
+ * - RX queue has to be one of the enabled MTL queues.
+ * - DMA channel has to be supported by HW or OSI_CHAN_ANY.
+ * - Priorities must not be steered to any other enabled RX queue, and can
+ *   only be steered to the queues MAC_RxQ_Ctrl2/3 cover.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] remap: RX queue remapping request.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t rxq_remap_validate(struct osi_core_priv_data *const osi_core,
+				  const struct osi_rxq_remap *const remap)
+{
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t found = OSI_DISABLE;
+	nveu32_t pmask = 0U;
+	nveu32_t i, q;
+	nve32_t ret = -1;
+
+	for (i = 0U; (i < osi_core->num_mtl_queues) &&
+	     (i < OSI_MGBE_MAX_NUM_QUEUES); i++) {
+		q = osi_core->mtl_queues[i];
+		if (q == remap->rxq) {
+			found = OSI_ENABLE;
+		} else if (q < OSI_MGBE_MAX_NUM_QUEUES) {
+			pmask |= osi_core->rxq_prio[q];
+		} else {
+			/* Not a valid queue, nothing to check against */
+		}
+	}
+
+	if ((found == OSI_DISABLE) || (remap->rxq >= OSI_MGBE_MAX_NUM_QUEUES) ||
+	    ((remap->dma_chan != OSI_CHAN_ANY) &&
+	     (remap->dma_chan >= l_core->num_max_chans))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid RX queue/DMA channel\n",
+			     (nveul64_t)remap->rxq);
+		goto fail;
+	}
+
+	if ((remap->prio > MAC_RQC2R_PSRQ_MASK) ||
+	    ((remap->prio & pmask) != OSI_NONE) ||
+	    ((remap->prio != OSI_NONE) &&
+	     (remap->rxq >= OSI_EQOS_MAX_NUM_QUEUES))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid RX queue priorities\n",
+			     (nveul64_t)remap->prio);
+		goto fail;
+	}
+
+	ret = 0;
+fail:
+	return ret;
+}
+
+/**
+ * @brief hw_remap_rxq - Remap an MTL RX queue at runtime
+ *
+ * Algorithm:
+ * - Validate the request.
+ * - Disable the RX queue in MAC_RxQ_Ctrl0 and wait until MTL drained it,
+ *   other RX queues keep receiving.
+ * - Program the queue DMA channel mapping and its PSRQ priorities.
+ * - Enable the RX queue again as per osi_core->rxq_ctrl[].
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] remap: RX queue remapping request.
+ *
+ * @note DMA channel to route to has to be running.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+nve32_t hw_remap_rxq(struct osi_core_priv_data *const osi_core,
+		     const struct osi_rxq_remap *const remap)
+{
+	nveu8_t *base = (nveu8_t *)osi_core->base;
+	const nveu32_t q = remap->rxq & 0xFU;
+	const nveu32_t rx_dbg[2] = { EQOS_MTL_CHX_RX_DEBUG(q),
+				     MGBE_MTL_CHX_RX_DEBUG(q) };
+	const nveu32_t dma_map[2] = { EQOS_MTL_RXQ_DMA_MAP0 + ((q / 4U) * 4U),
+				      MGBE_MTL_RXQ_DMA_MAP0 + ((q / 4U) * 4U) };
+	/* QxMDMACH and QxDDMACH fields of MTL_RxQ_DMA_Map */
+	const nveu32_t map_mask[2] = { 0x17U, 0x8FU };
+	const nveu32_t map_dcs[2] = { OSI_BIT(4), OSI_BIT(7) };
+	nveu32_t rqc0, value, field;
+	nve32_t ret;
+
+	ret = rxq_remap_validate(osi_core, remap);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	rqc0 = osi_readla(osi_core, base + MAC_RQC0R);
+	rqc0 &= ~(MAC_RQC0R_RXQEN_MASK << (q * 2U));
+	osi_writela(osi_core, rqc0, base + MAC_RQC0R);
+
+	ret = poll_check(osi_core, base + rx_dbg[osi_core->mac],
+			 (MTL_RXQ_DBG_PRXQ | MTL_RXQ_DBG_RXQSTS), &value);
+	if (ret < 0) {
+		goto enable;
+	}
+
+	value = osi_readla(osi_core, base + dma_map[osi_core->mac]);
+	field = (value >> RXQ_FIELD_SHIFT(q)) & map_mask[osi_core->mac];
+	if (remap->dma_chan == OSI_CHAN_ANY) {
+		field |= map_dcs[osi_core->mac];
+	} else {
+		field = remap->dma_chan;
+	}
+	value &= ~(map_mask[osi_core->mac] << RXQ_FIELD_SHIFT(q));
+	value |= (field << RXQ_FIELD_SHIFT(q));
+	osi_writela(osi_core, value, base + dma_map[osi_core->mac]);
+
+	if (q < OSI_EQOS_MAX_NUM_QUEUES) {
+		value = osi_readla(osi_core, base + MAC_RQC2R(q));
+		value &= ~(MAC_RQC2R_PSRQ_MASK << RXQ_FIELD_SHIFT(q));
+		value |= (remap->prio << RXQ_FIELD_SHIFT(q));
+		osi_writela(osi_core, value, base + MAC_RQC2R(q));
+		osi_core->rxq_prio[q] = remap->prio;
+	}
+
+enable:
+	rqc0 |= ((osi_core->rxq_ctrl[q] & MAC_RQC0R_RXQEN_MASK) << (q * 2U));
+	osi_writela(osi_core, rqc0, base + MAC_RQC0R);
+fail:
+	return ret;
+}
+
+/**
+ * @brief pfc_validate - Validate PFC configuration.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] pfc: PFC configuration.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t pfc_validate(struct osi_core_priv_data *const osi_core,
+			    const struct osi_pfc_config *const pfc)
+{
+	const nveu32_t max_q[2] = { OSI_EQOS_MAX_NUM_QUEUES,
+				    OSI_MGBE_MAX_NUM_QUEUES };
+	const nveu32_t min = MTL_FC_THRESH_MIN * MTL_FC_THRESH_UNIT;
+	const nveu32_t max = MTL_FC_THRESH_MAX * MTL_FC_THRESH_UNIT;
+	nveu32_t i;
+	nve32_t ret = -1;
+
+	if ((pfc->prio_mask != 0U) && (osi_core->hw_feature != OSI_NULL) &&
+	    (osi_core->hw_feature->pfc_en == OSI_DISABLE)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "PFC not supported in HW\n", 0ULL);
+		goto fail;
+	}
+
+	if ((pfc->prio_mask > 0xFFU) ||
+	    (pfc->pause_quanta > MAC_PFC_PAUSE_QUANTA_DFLT)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid PFC prio_mask/pause_quanta\n",
+			     (nveul64_t)pfc->prio_mask);
+		goto fail;
+	}
+
+	for (i = 0U; i < OSI_MAX_TC_NUM; i++) {
+		if (pfc->tx_prio[i] > 0xFFU) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "Invalid PFC tx_prio\n", (nveul64_t)i);
+			goto fail;
+		}
+	}
+
+	/* Pause can only be generated for RX queues with Tx_Flow_Ctrl */
+	for (i = MAC_QX_TX_FLW_CTRL_MAX; i < max_q[osi_core->mac]; i++) {
+		if ((osi_core->rxq_prio[i] & pfc->prio_mask) != 0U) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "PFC priority on RX queue without pause\n",
+				     (nveul64_t)i);
+			goto fail;
+		}
+	}
+
+	for (i = 0U; i < OSI_MGBE_MAX_NUM_QUEUES; i++) {
+		if ((pfc->rfa[i] == 0U) && (pfc->rfd[i] == 0U)) {
+			continue;
+		}
+
+		if ((i >= max_q[osi_core->mac]) ||
+		    ((pfc->rfa[i] % MTL_FC_THRESH_UNIT) != 0U) ||
+		    ((pfc->rfd[i] % MTL_FC_THRESH_UNIT) != 0U) ||
+		    ((pfc->rfa[i] != 0U) &&
+		     ((pfc->rfa[i] < min) || (pfc->rfa[i] > max))) ||
+		    ((pfc->rfd[i] != 0U) &&
+		     ((pfc->rfd[i] < min) || (pfc->rfd[i] > max))) ||
+		    ((pfc->rfa[i] != 0U) && (pfc->rfd[i] != 0U) &&
+		     (pfc->rfd[i] < pfc->rfa[i]))) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "Invalid PFC threshold\n", (nveul64_t)i);
+			goto fail;
+		}
+	}
+
+	ret = 0;
+fail:
+	return ret;
+}
+
+/**
+ * @brief hw_config_pfc - Configure 802.1Qbb priority flow control.
+ *
+ * Algorithm:
+ * 1) Program the RX queue thresholds pause is sent and released at.
+ * 2) Program the priorities received PFC frames pause each TX queue
+ *    (EQOS) or TC (MGBE) for, only the fields with a tx_prio given.
+ * 3) Enable pause generation with the pause quanta on the RX queues
+ *    that have priorities of prio_mask steered to them, see rxq_prio.
+ *    Only RX queues 0-7 can generate pause.
+ * 4) Set PFCE, or clear it and restore link level pause from flow_ctrl
+ *    if prio_mask is 0.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] pfc: PFC configuration.
+ *
+ * @note MAC should be init and started. see osi_start_mac()
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+nve32_t hw_config_pfc(struct osi_core_priv_data *const osi_core,
+		      const struct osi_pfc_config *const pfc)
+{
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu8_t *base = (nveu8_t *)osi_core->base;
+	const nveu32_t mac = osi_core->mac;
+	const nveu32_t max_q[2] = { OSI_EQOS_MAX_NUM_QUEUES,
+				    OSI_MGBE_MAX_NUM_QUEUES };
+	const nveu32_t prty_map[2] = { EQOS_MAC_TXQ_PRTY_MAP0,
+				       MGBE_MTL_TCPM0R };
+	const nveu32_t rfa_shift[2] = { EQOS_MTL_RXQ_OP_MODE_RFA_SHIFT,
+					MGBE_MTL_RXQ_OP_MODE_RFA_SHIFT };
+	const nveu32_t rfa_mask[2] = { EQOS_MTL_RXQ_OP_MODE_RFA_MASK,
+				       MGBE_MTL_RXQ_OP_MODE_RFA_MASK };
+	const nveu32_t rfd_shift[2] = { EQOS_MTL_RXQ_OP_MODE_RFD_SHIFT,
+					MGBE_MTL_RXQ_OP_MODE_RFD_SHIFT };
+	const nveu32_t rfd_mask[2] = { EQOS_MTL_RXQ_OP_MODE_RFD_MASK,
+				       MGBE_MTL_RXQ_OP_MODE_RFD_MASK };
+	nveu32_t quanta = (pfc->pause_quanta == 0U) ?
+			  MAC_PFC_PAUSE_QUANTA_DFLT : pfc->pause_quanta;
+	nveu32_t i, reg, value;
+	nve32_t ret;
+
+	ret = pfc_validate(osi_core, pfc);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	for (i = 0U; i < max_q[mac]; i++) {
+		if ((pfc->rfa[i] == 0U) && (pfc->rfd[i] == 0U)) {
+			continue;
+		}
+
+		reg = (mac == OSI_MAC_HW_EQOS) ? EQOS_MTL_CHX_RX_OP_MODE(i) :
+		      MGBE_MTL_RXQ_FLOW_CTRL(i);
+		value = osi_readla(osi_core, base + reg);
+		if (pfc->rfa[i] != 0U) {
+			value &= ~rfa_mask[mac];
+			value |= (((pfc->rfa[i] / MTL_FC_THRESH_UNIT) - 2U) <<
+				  rfa_shift[mac]) & rfa_mask[mac];
+		}
+		if (pfc->rfd[i] != 0U) {
+			value &= ~rfd_mask[mac];
+			value |= (((pfc->rfd[i] / MTL_FC_THRESH_UNIT) - 2U) <<
+				  rfd_shift[mac]) & rfd_mask[mac];
+		}
+		osi_writela(osi_core, value, base + reg);
 	}
-#else
-	mac_tcr = (OSI_MAC_TCR_TSENA | OSI_MAC_TCR_TSCFUPDT | OSI_MAC_TCR_TSCTRLSSR
-		   | OSI_MAC_TCR_TSVER2ENA | OSI_MAC_TCR_TSIPENA | OSI_MAC_TCR_TSIPV6ENA |
-		   OSI_MAC_TCR_TSIPV4ENA | OSI_MAC_TCR_SNAPTYPSEL_1);
-#endif /* !OSI_STRIPPED_LIB */
 
-	osi_writela(osi_core, mac_tcr, ((nveu8_t *)addr + mac_tscr[osi_core->mac]));
+	for (i = 0U; i < OSI_MAX_TC_NUM; i++) {
+		if (pfc->tx_prio[i] == 0U) {
+			/* Keep the current mapping */
+			continue;
+		}
 
-	value = osi_readla(osi_core, (nveu8_t *)addr + mac_pps[osi_core->mac]);
-	value &= ~MAC_PPS_CTL_PPSCTRL0;
-	if (l_core->pps_freq == OSI_ENABLE) {
-		value |= OSI_ENABLE;
+		reg = prty_map[mac] + ((i / 4U) * 4U);
+		value = osi_readla(osi_core, base + reg);
+		value &= ~(0xFFU << RXQ_FIELD_SHIFT(i));
+		value |= (pfc->tx_prio[i] << RXQ_FIELD_SHIFT(i));
+		osi_writela(osi_core, value, base + reg);
+	}
+
+	for (i = 0U; i < MAC_QX_TX_FLW_CTRL_MAX; i++) {
+		value = osi_readla(osi_core, base + MAC_QX_TX_FLW_CTRL(i));
+		if ((osi_core->rxq_prio[i] & pfc->prio_mask) != 0U) {
+			value |= MAC_QX_TX_FLW_CTRL_TFE;
+			value &= ~MAC_QX_TX_FLW_CTRL_PT_MASK;
+			value |= (quanta << MAC_QX_TX_FLW_CTRL_PT_SHIFT) &
+				 MAC_QX_TX_FLW_CTRL_PT_MASK;
+		} else {
+			value &= ~MAC_QX_TX_FLW_CTRL_TFE;
+		}
+		osi_writela(osi_core, value, base + MAC_QX_TX_FLW_CTRL(i));
+	}
+
+	value = osi_readla(osi_core, base + MAC_RX_FLW_CTRL);
+	if (pfc->prio_mask != 0U) {
+		value |= (MAC_RX_FLW_CTRL_PFCE | MAC_RX_FLW_CTRL_RFE);
+		osi_writela(osi_core, value, base + MAC_RX_FLW_CTRL);
+	} else {
+		value &= ~MAC_RX_FLW_CTRL_PFCE;
+		osi_writela(osi_core, value, base + MAC_RX_FLW_CTRL);
+		/* Queue 0 pause and RFE back to link level setting */
+		ret = l_core->ops_p->config_flow_control(osi_core,
+							 osi_core->flow_ctrl);
 	}
-	osi_writela(osi_core, value, ((nveu8_t *)addr + mac_pps[osi_core->mac]));
+fail:
+	return ret;
 }
 
-void hw_config_ssir(struct osi_core_priv_data *const osi_core)
+/**
+ * @brief hw_pfc_stats - Update pause and PFC stats.
+ *
+ * Algorithm: Copy pause frame counters from MMC. With PFC enabled,
+ *	count a congestion sample for the PFC priorities of each RX queue
+ *	filled above its activate threshold, HW has no per priority pause
+ *	counters.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @note MMC counters should be read. see OSI_CMD_READ_MMC
+ */
+void hw_pfc_stats(struct osi_core_priv_data *const osi_core)
 {
-	nveu32_t val = 0U;
-	void *addr = osi_core->base;
 	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
-	const nveu32_t mac_ssir[2] = { EQOS_MAC_SSIR, MGBE_MAC_SSIR};
-	const nveu32_t ptp_ssinc[3] = {OSI_PTP_SSINC_4, OSI_PTP_SSINC_6, OSI_PTP_SSINC_4};
+	struct osi_stats *stats = &osi_core->stats;
+	nveu8_t *base = (nveu8_t *)osi_core->base;
+	nveu32_t prio, q, p, reg, value;
 
-	/* by default Fine method is enabled */
-	/* Fix the SSINC value based on Exact MAC used */
-	val = ptp_ssinc[l_core->l_mac_ver];
+	stats->pfc_tx_pause_n = osi_core->mmc.mmc_tx_pause_frame;
+	stats->pfc_rx_pause_n = osi_core->mmc.mmc_rx_pause_frames;
 
-	val |= val << MAC_SSIR_SSINC_SHIFT;
-	/* update Sub-second Increment Value */
-	osi_writela(osi_core, val, ((nveu8_t *)addr + mac_ssir[osi_core->mac]));
+	for (q = 0U; q < MAC_QX_TX_FLW_CTRL_MAX; q++) {
+		prio = osi_core->rxq_prio[q] & l_core->cfg.pfc.prio_mask;
+		if (prio == 0U) {
+			continue;
+		}
+
+		reg = (osi_core->mac == OSI_MAC_HW_EQOS) ?
+		      EQOS_MTL_CHX_RX_DEBUG(q) : MGBE_MTL_CHX_RX_DEBUG(q);
+		value = osi_readla(osi_core, base + reg);
+		if ((value & MTL_RXQ_DBG_RXQSTS) < MTL_RXQ_DBG_RXQSTS_FC) {
+			continue;
+		}
+
+		for (p = 0U; p < OSI_MAX_TC_NUM; p++) {
+			if ((prio & OSI_BIT(p)) != 0U) {
+				stats->pfc_congested_n[p] =
+					osi_update_stats_counter(stats->pfc_congested_n[p], 1UL);
+			}
+		}
+	}
 }
+#endif /* !OSI_STRIPPED_LIB */
 
 nve32_t hw_ptp_tsc_capture(struct osi_core_priv_data *const osi_core,
 			   struct osi_core_ptp_tsc_data *data)
@@ -529,9 +1362,15 @@ nve32_t hw_config_mac_pkt_filter_reg(struct osi_core_priv_data *const osi_core,
 				     const struct osi_filter *filter)
 {
 	nveu32_t value = 0U;
+#ifndef OSI_STRIPPED_LIB
+	nveu32_t old;
+#endif /* !OSI_STRIPPED_LIB */
 	nve32_t ret = 0;
 
 	value = osi_readla(osi_core, ((nveu8_t *)osi_core->base + MAC_PKT_FILTER_REG));
+#ifndef OSI_STRIPPED_LIB
+	old = value;
+#endif /* !OSI_STRIPPED_LIB */
 
 	/*Retain all other values */
 	value &= (MAC_PFR_DAIF | MAC_PFR_DBF  | MAC_PFR_SAIF |
@@ -562,6 +1401,14 @@ nve32_t hw_config_mac_pkt_filter_reg(struct osi_core_priv_data *const osi_core,
 	if ((filter->oper_mode & OSI_OPER_DIS_ALLMULTI) != OSI_DISABLE) {
 		value &= ~MAC_PFR_PM;
 	}
+
+	/* Keep hash filtering set up by L2 address list, along with perfect
+	 * filtering unless the caller turns perfect filtering off */
+	value |= (old & (MAC_PFR_HMC | MAC_PFR_HUC));
+	if (((value & (MAC_PFR_HMC | MAC_PFR_HUC)) != OSI_DISABLE) &&
+	    ((filter->oper_mode & OSI_OPER_DIS_PERFECT) == OSI_DISABLE)) {
+		value |= MAC_PFR_HPF;
+	}
 #endif /* !OSI_STRIPPED_LIB */
 
 	osi_writela(osi_core, value,
@@ -710,6 +1557,7 @@ static nve32_t gcl_validate(struct osi_core_priv_data *const osi_core,
 	nveu64_t ctr = 0U;
 	nveu64_t btr_new = 0U;
 	nveu32_t btr_l, btr_h, ctr_l, ctr_h;
+	const struct core_est_bank *hw_bank;
 	nveu32_t bunk = 0U;
 	nveu32_t est_status;
 	nveu64_t old_btr, old_ctr;
@@ -816,16 +1664,24 @@ static nve32_t gcl_validate(struct osi_core_priv_data *const osi_core,
 		bunk = MTL_EST_DBGB;
 	}
 
-	/* Read last BTR and CTR */
-	for (i = 0U; i < (sizeof(hw_read_arr) / sizeof(hw_read_arr[0])); i++) {
-		ret = hw_est_read(osi_core, hw_read_arr[i].addr,
-				  hw_read_arr[i].var, OSI_DISABLE,
-				  bunk, mac);
-		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "Reading failed for index\n",
-				     (nveul64_t)i);
-			goto done;
+	/* Last BTR and CTR, from HW only if bank content is unknown */
+	hw_bank = &l_core->est_bank[(bunk == 0U) ? 0U : 1U];
+	if (hw_bank->valid == OSI_ENABLE) {
+		btr_l = hw_bank->btr[0];
+		btr_h = hw_bank->btr[1];
+		ctr_l = hw_bank->ctr[0];
+		ctr_h = hw_bank->ctr[1];
+	} else {
+		for (i = 0U; i < (sizeof(hw_read_arr) / sizeof(hw_read_arr[0])); i++) {
+			ret = hw_est_read(osi_core, hw_read_arr[i].addr,
+					  hw_read_arr[i].var, OSI_DISABLE,
+					  bunk, mac);
+			if (ret < 0) {
+				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+					     "Reading failed for index\n",
+					     (nveul64_t)i);
+				goto done;
+			}
 		}
 	}
 
@@ -855,10 +1711,47 @@ done:
 	return ret;
 }
 
+/**
+ * @brief est_wait_idle - Wait for indirect GCL access to complete
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @retval 0 on success
+ * @retval -1 on timeout or if the access failed.
+ */
+static nve32_t est_wait_idle(struct osi_core_priv_data *osi_core)
+{
+	nve32_t retry = 1000;
+	nveu32_t val;
+	nve32_t ret = 0;
+	const nveu32_t MTL_EST_GCL_CONTROL[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_GCL_CONTROL,
+						MGBE_MTL_EST_GCL_CONTROL};
+
+	val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
+			 MTL_EST_GCL_CONTROL[osi_core->mac]);
+	while (((val & MTL_EST_SRWO) == MTL_EST_SRWO) && (--retry > 0)) {
+		osi_core->osd_ops.udelay(OSI_DELAY_1US);
+		val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
+				 MTL_EST_GCL_CONTROL[osi_core->mac]);
+	}
+
+	if (((val & MTL_EST_ERR0) == MTL_EST_ERR0) ||
+	    (retry <= 0)) {
+		ret = -1;
+	}
+
+	return ret;
+}
+
 /**
  * @brief hw_est_write - indirect write the GCL to Software own list
  * (SWOL)
  *
+ * Algorithm: Wait for the previous indirect access to complete and issue
+ * this one without waiting for it, so the completion wait of a write
+ * overlaps setting up the next one. est_wait_idle() has to be called after
+ * the last write.
+ *
  * @param[in] osi_core: OSI core private data structure.
  * @param[in] addr_val: Address offset for indirect write.
  * @param[in] data: Data to be written at offset.
@@ -874,14 +1767,18 @@ static nve32_t hw_est_write(struct osi_core_priv_data *osi_core,
 			    nveu32_t addr_val, nveu32_t data,
 			    nveu32_t gcla)
 {
-	nve32_t retry = 1000;
 	nveu32_t val = 0x0;
-	nve32_t ret = 0;
+	nve32_t ret;
 	const nveu32_t MTL_EST_DATA[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_DATA,
 						MGBE_MTL_EST_DATA};
 	const nveu32_t MTL_EST_GCL_CONTROL[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_GCL_CONTROL,
 						MGBE_MTL_EST_GCL_CONTROL};
 
+	ret = est_wait_idle(osi_core);
+	if (ret < 0) {
+		goto done;
+	}
+
 	osi_writela(osi_core, data, (nveu8_t *)osi_core->base +
 		   MTL_EST_DATA[osi_core->mac]);
 
@@ -891,24 +1788,46 @@ static nve32_t hw_est_write(struct osi_core_priv_data *osi_core,
 	val |= addr_val;
 	osi_writela(osi_core, val, (nveu8_t *)osi_core->base +
 		    MTL_EST_GCL_CONTROL[osi_core->mac]);
+done:
+	return ret;
+}
 
-	while (--retry > 0) {
-		val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
-				 MTL_EST_GCL_CONTROL[osi_core->mac]);
-		if ((val & MTL_EST_SRWO) == MTL_EST_SRWO) {
-			osi_core->osd_ops.udelay(OSI_DELAY_1US);
-			continue;
-		}
-
-		break;
+/**
+ * @brief est_swap_time - Compute GCL switch time
+ *
+ * Algorithm: Move base time to the first cycle boundary of the GCL in use
+ * which is at least MTL_EST_SWAP_MARGIN_NS ahead, so the new GCL takes over
+ * without truncating a cycle of the current one.
+ *
+ * @param[in] hw_bank: GCL bank in use by HW, with known content.
+ * @param[in, out] btr: Current time in, base time out. Index 0 for nsec,
+ *		       index 1 for sec.
+ */
+static void est_swap_time(const struct core_est_bank *const hw_bank,
+			  nveu32_t *btr)
+{
+	nveu64_t now = ((nveu64_t)btr[1] * OSI_NSEC_PER_SEC) + btr[0];
+	nveu64_t old_btr = ((nveu64_t)hw_bank->btr[1] * OSI_NSEC_PER_SEC) +
+			   hw_bank->btr[0];
+	nveu64_t old_ctr = ((nveu64_t)hw_bank->ctr[1] * OSI_NSEC_PER_SEC) +
+			   hw_bank->ctr[0];
+	nveu64_t at = now + MTL_EST_SWAP_MARGIN_NS;
+
+	if (old_ctr == 0U) {
+		goto done;
 	}
 
-	if (((val & MTL_EST_ERR0) == MTL_EST_ERR0) ||
-	    (retry <= 0)) {
-		ret = -1;
+	if (at > old_btr) {
+		at = old_btr + ((((at - old_btr) + old_ctr) - 1U) / old_ctr) *
+		     old_ctr;
+	} else {
+		at = old_btr;
 	}
 
-	return ret;
+	btr[0] = (nveu32_t)(at % OSI_NSEC_PER_SEC);
+	btr[1] = (nveu32_t)(at / OSI_NSEC_PER_SEC);
+done:
+	return;
 }
 
 /**
@@ -916,15 +1835,15 @@ static nve32_t hw_est_write(struct osi_core_priv_data *osi_core,
  * registers.
  *
  * Algorithm:
- * 1) Write  TER, LLR and EST control register
- * 2) Update GCL to sw own GCL (MTL_EST_Status bit SWOL will tell which is
- *    owned by SW) and store which GCL is in use currently in sw.
- * 3) TODO set DBGB and DBGM for debugging
- * 4) EST_data and GCRR to 1, update entry sno in ADDR and put data at
- *    est_gcl_data enable GCL MTL_EST_SSWL and wait for self clear or use
- *    SWLC in MTL_EST_Status. Please note new GCL will be pushed for each entry.
- * 5) Configure btr. Update btr based on current time (current time
- *    should be updated based on PTP by this time)
+ * 1) Find GCL memory bank owned by SW (MTL_EST_Status SWOL).
+ * 2) If no base time given take PTP time, moved to the next cycle boundary
+ *    of the GCL in use when EST is running and that GCL is known.
+ * 3) Validate GCL.
+ * 4) Write CTR, TER, LLR and GCL entries which differ from what was last
+ *    programmed into the SW owned bank, all of them if that is not known,
+ *    and BTR. Writes are issued back to back, see hw_est_write().
+ * 5) Set MTL_EST_SSWL so HW switches to the new GCL at base time, see
+ *    hw_est_wait_swap().
  *
  * @param[in] osi_core: OSI core private data structure.
  * @param[in] est: EST configuration input argument.
@@ -937,14 +1856,18 @@ static nve32_t hw_est_write(struct osi_core_priv_data *osi_core,
 nve32_t hw_config_est(struct osi_core_priv_data *const osi_core,
 		      struct osi_est_config *const est)
 {
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct core_est_bank *bank;
 	nveu32_t btr[2] = {0};
 	nveu32_t val = 0x0;
 	void *base = osi_core->base;
-	nveu32_t i;
+	nveu32_t i, swb;
 	nve32_t ret = 0;
 	nveu32_t addr = 0x0;
 	const nveu32_t MTL_EST_CONTROL[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_CONTROL,
 						MGBE_MTL_EST_CONTROL};
+	const nveu32_t MTL_EST_STATUS[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_STATUS,
+						MGBE_MTL_EST_STATUS};
 	const nveu32_t MTL_EST_BTR_LOW[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_BTR_LOW,
 						MGBE_MTL_EST_BTR_LOW};
 	const nveu32_t MTL_EST_BTR_HIGH[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_BTR_HIGH,
@@ -975,12 +1898,24 @@ nve32_t hw_config_est(struct osi_core_priv_data *const osi_core,
 
 		ret = 0;
 	} else {
+		val = osi_readla(osi_core, (nveu8_t *)base +
+				 MTL_EST_STATUS[osi_core->mac]);
+		swb = ((val & MTL_EST_STATUS_SWOL) == MTL_EST_STATUS_SWOL) ?
+		      1U : 0U;
+		bank = &l_core->est_bank[swb];
+
 		btr[0] = est->btr[0];
 		btr[1] = est->btr[1];
 		if ((btr[0] == 0U) && (btr[1] == 0U)) {
 			common_get_systime_from_mac(osi_core->base,
 						    osi_core->mac,
 						    &btr[1], &btr[0]);
+			val = osi_readla(osi_core, (nveu8_t *)base +
+					 MTL_EST_CONTROL[osi_core->mac]);
+			if (((val & MTL_EST_EEST) == MTL_EST_EEST) &&
+			    (l_core->est_bank[swb ^ 1U].valid == OSI_ENABLE)) {
+				est_swap_time(&l_core->est_bank[swb ^ 1U], btr);
+			}
 		}
 
 		if (gcl_validate(osi_core, est, btr, osi_core->mac) < 0) {
@@ -990,38 +1925,59 @@ nve32_t hw_config_est(struct osi_core_priv_data *const osi_core,
 			goto done;
 		}
 
-		ret = hw_est_write(osi_core, MTL_EST_CTR_LOW[osi_core->mac], est->ctr[0], 0);
-		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "GCL CTR[0] failed\n", 0LL);
-			goto done;
-		}
 		/* check for est->ctr[i]  not more than FF, TODO as per hw config
 		 * parameter we can have max 0x3 as this value in sec */
 		est->ctr[1] &= MTL_EST_CTR_HIGH_MAX;
-		ret = hw_est_write(osi_core, MTL_EST_CTR_HIGH[osi_core->mac], est->ctr[1], 0);
-		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "GCL CTR[1] failed\n", 0LL);
-			goto done;
+		btr[0] += est->btr_offset[0];
+		btr[1] += est->btr_offset[1];
+
+		if ((bank->valid != OSI_ENABLE) || (bank->ctr[0] != est->ctr[0])) {
+			ret = hw_est_write(osi_core, MTL_EST_CTR_LOW[osi_core->mac],
+					   est->ctr[0], 0);
+			if (ret < 0) {
+				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+					     "GCL CTR[0] failed\n", 0LL);
+				goto fail;
+			}
 		}
 
-		ret = hw_est_write(osi_core, MTL_EST_TER[osi_core->mac], est->ter, 0);
-		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "GCL TER failed\n", 0LL);
-			goto done;
+		if ((bank->valid != OSI_ENABLE) || (bank->ctr[1] != est->ctr[1])) {
+			ret = hw_est_write(osi_core, MTL_EST_CTR_HIGH[osi_core->mac],
+					   est->ctr[1], 0);
+			if (ret < 0) {
+				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+					     "GCL CTR[1] failed\n", 0LL);
+				goto fail;
+			}
 		}
 
-		ret = hw_est_write(osi_core, MTL_EST_LLR[osi_core->mac], est->llr, 0);
-		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "GCL LLR failed\n", 0LL);
-			goto done;
+		if ((bank->valid != OSI_ENABLE) || (bank->ter != est->ter)) {
+			ret = hw_est_write(osi_core, MTL_EST_TER[osi_core->mac],
+					   est->ter, 0);
+			if (ret < 0) {
+				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+					     "GCL TER failed\n", 0LL);
+				goto fail;
+			}
+		}
+
+		if ((bank->valid != OSI_ENABLE) || (bank->llr != est->llr)) {
+			ret = hw_est_write(osi_core, MTL_EST_LLR[osi_core->mac],
+					   est->llr, 0);
+			if (ret < 0) {
+				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+					     "GCL LLR failed\n", 0LL);
+				goto fail;
+			}
 		}
 
 		/* Write GCL table */
 		for (i = 0U; i < est->llr; i++) {
+			if ((bank->valid == OSI_ENABLE) &&
+			    (i < bank->llr) && (bank->gcl[i] == est->gcl[i])) {
+				continue;
+			}
+
 			addr = i;
 			addr = addr << MTL_EST_ADDR_SHIFT;
 			addr &= MTL_EST_ADDR_MASK;
@@ -1030,38 +1986,127 @@ nve32_t hw_config_est(struct osi_core_priv_data *const osi_core,
 				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
 					     "GCL enties write failed\n",
 					     (nveul64_t)i);
-				goto done;
+				goto fail;
 			}
 		}
 
 		/* Write parameters */
 		ret = hw_est_write(osi_core, MTL_EST_BTR_LOW[osi_core->mac],
-				btr[0] + est->btr_offset[0], OSI_DISABLE);
+				   btr[0], OSI_DISABLE);
 		if (ret < 0) {
 			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "GCL BTR[0] failed\n",
-				     (btr[0] + est->btr_offset[0]));
-			goto done;
+				     "GCL BTR[0] failed\n", btr[0]);
+			goto fail;
 		}
 
 		ret = hw_est_write(osi_core, MTL_EST_BTR_HIGH[osi_core->mac],
-				btr[1] + est->btr_offset[1], OSI_DISABLE);
+				   btr[1], OSI_DISABLE);
 		if (ret < 0) {
 			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "GCL BTR[1] failed\n",
-				     (btr[1] + est->btr_offset[1]));
-			goto done;
+				     "GCL BTR[1] failed\n", btr[1]);
+			goto fail;
+		}
+
+		ret = est_wait_idle(osi_core);
+		if (ret < 0) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "GCL write failed\n", 0LL);
+			goto fail;
 		}
 
+		bank->btr[0] = btr[0];
+		bank->btr[1] = btr[1];
+		bank->ctr[0] = est->ctr[0];
+		bank->ctr[1] = est->ctr[1];
+		bank->ter = est->ter;
+		bank->llr = est->llr;
+		(void)osi_memcpy(bank->gcl, est->gcl,
+				 (nveu64_t)est->llr * sizeof(nveu32_t));
+		bank->valid = OSI_ENABLE;
+
 		val = osi_readla(osi_core, (nveu8_t *)base +
 				 MTL_EST_CONTROL[osi_core->mac]);
 		/* Store table */
 		val |= MTL_EST_SSWL;
 		val |= MTL_EST_EEST;
 		val |= MTL_EST_QHLBF;
+		osi_core->est_ready = OSI_DISABLE;
 		osi_writela(osi_core, val, (nveu8_t *)base +
 			    MTL_EST_CONTROL[osi_core->mac]);
 	}
+	goto done;
+
+fail:
+	bank->valid = OSI_DISABLE;
+done:
+	return ret;
+}
+
+/**
+ * @brief hw_est_wait_swap - Wait for HW to switch to the GCL last configured
+ *
+ * Algorithm: Poll MTL_EST_SSWL, HW clears it once the SW owned GCL became
+ * the one in use, which happens at the base time programmed with it. That
+ * is at most one cycle of the GCL in use plus the programming margin
+ * away, see est_swap_time(), a longer timeout is rejected.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] timeout_ms: Time to wait in milli seconds, 0 to only check.
+ *
+ * @retval 0 if switch is done
+ * @retval -1 if timeout is too long, EST is not enabled or switch is
+ *	    still pending.
+ */
+nve32_t hw_est_wait_swap(struct osi_core_priv_data *const osi_core,
+			 const nveu32_t timeout_ms)
+{
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	const nveu32_t MTL_EST_CONTROL[MAX_MAC_IP_TYPES] = {EQOS_MTL_EST_CONTROL,
+						MGBE_MTL_EST_CONTROL};
+	nveu8_t *addr = (nveu8_t *)osi_core->base + MTL_EST_CONTROL[osi_core->mac];
+	nveu64_t max_ns = MTL_EST_SWAP_MARGIN_NS;
+	nveu64_t ctr;
+	nveu32_t count = 0U;
+	nveu32_t val, i;
+	nve32_t ret = -1;
+
+	for (i = 0U; i < 2U; i++) {
+		if (l_core->est_bank[i].valid != OSI_ENABLE) {
+			continue;
+		}
+		ctr = ((nveu64_t)l_core->est_bank[i].ctr[1] * OSI_NSEC_PER_SEC) +
+		      l_core->est_bank[i].ctr[0];
+		if ((ctr + MTL_EST_SWAP_MARGIN_NS) > max_ns) {
+			max_ns = ctr + MTL_EST_SWAP_MARGIN_NS;
+		}
+	}
+
+	if ((nveu64_t)timeout_ms >
+	    ((max_ns + MTL_EST_NSEC_PER_MSEC - 1U) / MTL_EST_NSEC_PER_MSEC)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "EST: GCL switch timeout too long\n",
+			     (nveul64_t)timeout_ms);
+		goto done;
+	}
+
+	val = osi_readla(osi_core, addr);
+	while (((val & (MTL_EST_EEST | MTL_EST_SSWL)) ==
+		(MTL_EST_EEST | MTL_EST_SSWL)) && (count < timeout_ms)) {
+		osi_core->osd_ops.udelay(OSI_DELAY_1000US);
+		count++;
+		val = osi_readla(osi_core, addr);
+	}
+
+	if ((val & MTL_EST_EEST) != MTL_EST_EEST) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "EST not enabled\n", 0ULL);
+	} else if ((val & MTL_EST_SSWL) == MTL_EST_SSWL) {
+		OSI_CORE_INFO(osi_core->osd, OSI_LOG_ARG_INVALID,
+			      "EST: GCL switch pending\n", (nveul64_t)timeout_ms);
+	} else {
+		ret = 0;
+	}
+
 done:
 	return ret;
 }
@@ -1102,8 +2147,9 @@ nve32_t hw_config_fpe(struct osi_core_priv_data *const osi_core,
 						MGBE_MAC_RQC1R_RQ};
 	const nveu32_t MAC_RQC1R_RQ_SHIFT[MAX_MAC_IP_TYPES] = {EQOS_MAC_RQC1R_FPRQ_SHIFT,
 						MGBE_MAC_RQC1R_RQ_SHIFT};
-	const nveu32_t MTL_FPE_ADV[MAX_MAC_IP_TYPES] = {EQOS_MTL_FPE_ADV,
-						MGBE_MTL_FPE_ADV};
+#ifndef OSI_STRIPPED_LIB
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+#endif /* !OSI_STRIPPED_LIB */
 
 	if ((osi_core->hw_feature != OSI_NULL) &&
 	    (osi_core->hw_feature->fpe_sel == OSI_DISABLE)) {
@@ -1122,6 +2168,17 @@ nve32_t hw_config_fpe(struct osi_core_priv_data *const osi_core,
 		goto error;
 	}
 
+#ifndef OSI_STRIPPED_LIB
+	if ((fpe->frag_size > (MTL_FPE_FRAG_UNIT * (MTL_FPE_AFSZ_MAX + 1U))) ||
+	    ((fpe->frag_size % MTL_FPE_FRAG_UNIT) != 0U)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "FPE input frag_size is invalid\n",
+			     (nveul64_t)fpe->frag_size);
+		ret = -1;
+		goto error;
+	}
+#endif /* !OSI_STRIPPED_LIB */
+
 	if (osi_core->mac == OSI_MAC_HW_MGBE) {
 #ifdef MACSEC_SUPPORT
 		osi_lock_irq_enabled(&osi_core->macsec_fpe_lock);
@@ -1156,6 +2213,9 @@ nve32_t hw_config_fpe(struct osi_core_priv_data *const osi_core,
 			osi_core->is_fpe_enabled = OSI_DISABLE;
 #endif /*  MACSEC_SUPPORT */
 		}
+#ifndef OSI_STRIPPED_LIB
+		l_core->fpe_enabled = OSI_DISABLE;
+#endif /* !OSI_STRIPPED_LIB */
 		ret = 0;
 	} else {
 		val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
@@ -1217,13 +2277,21 @@ nve32_t hw_config_fpe(struct osi_core_priv_data *const osi_core,
 		osi_writela(osi_core, val, (nveu8_t *)osi_core->base +
 			    MAC_FPE_CTS[osi_core->mac]);
 
-		val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
-				 MTL_FPE_ADV[osi_core->mac]);
-		val &= ~MTL_FPE_ADV_HADV_MASK;
-		//(minimum_fragment_size +IPG/EIPG + Preamble) *.8 ~98ns for10G
-		val |= MTL_FPE_ADV_HADV_VAL;
-		osi_writela(osi_core, val, (nveu8_t *)osi_core->base +
-			    MTL_FPE_ADV[osi_core->mac]);
+#ifndef OSI_STRIPPED_LIB
+		l_core->fpe_afsz = (fpe->frag_size == 0U) ? 0U :
+				   ((fpe->frag_size / MTL_FPE_FRAG_UNIT) - 1U);
+		l_core->fpe_afsz_base = l_core->fpe_afsz;
+		l_core->fpe_frag_auto = fpe->frag_auto;
+		l_core->fpe_quiet = 0U;
+		/* Tuning only looks at counts from here on */
+		l_core->ops_p->read_mmc(osi_core);
+		l_core->fpe_frag_last = osi_core->mmc.mmc_tx_fpe_frag_cnt;
+		l_core->fpe_hold_last = osi_core->mmc.mmc_tx_fpe_hold_req_cnt;
+		l_core->fpe_enabled = OSI_ENABLE;
+		fpe_set_frag(osi_core, l_core->fpe_afsz);
+#else
+		fpe_set_frag(osi_core, 0U);
+#endif /* !OSI_STRIPPED_LIB */
 
 		if (osi_core->mac == OSI_MAC_HW_MGBE) {
 #ifdef MACSEC_SUPPORT
@@ -1243,6 +2311,94 @@ error:
 	return ret;
 }
 
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief fpe_tune_frag - Tune FPE fragment size from TX fragmentation.
+ *
+ * Algorithm: A preempted frame is sent in at least two fragments, more
+ *	fragments per hold request mean preemptable frames are chopped at
+ *	every min fragment boundary.
+ *	1) Above MTL_FPE_TUNE_FRAG_HIGH fragments per hold request step the
+ *	   min fragment size up by 64 bytes.
+ *	2) After MTL_FPE_TUNE_QUIET reads at or below MTL_FPE_TUNE_FRAG_LOW
+ *	   step it back down, never below the configured size.
+ *	RX reassembly and SMD errors are the link partner's TX side and are
+ *	only reported. Hold requests come from EST gate hold operations,
+ *	without them fragments can't be related to preempted frames and
+ *	the fragment size is left as is.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ */
+static void fpe_tune_frag(struct osi_core_priv_data *const osi_core)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	const struct osi_mmc_counters *mmc = &osi_core->mmc;
+	nveu64_t frag = 0U, hold = 0U;
+
+	/* Lower after MMC reset, which doesn't count as new fragments */
+	if ((mmc->mmc_tx_fpe_frag_cnt >= l_core->fpe_frag_last) &&
+	    (mmc->mmc_tx_fpe_hold_req_cnt >= l_core->fpe_hold_last)) {
+		frag = mmc->mmc_tx_fpe_frag_cnt - l_core->fpe_frag_last;
+		hold = mmc->mmc_tx_fpe_hold_req_cnt - l_core->fpe_hold_last;
+	}
+	l_core->fpe_frag_last = mmc->mmc_tx_fpe_frag_cnt;
+	l_core->fpe_hold_last = mmc->mmc_tx_fpe_hold_req_cnt;
+
+	if ((hold != 0U) && (frag > (hold * MTL_FPE_TUNE_FRAG_HIGH))) {
+		l_core->fpe_quiet = 0U;
+		if (l_core->fpe_afsz < MTL_FPE_AFSZ_MAX) {
+			l_core->fpe_afsz++;
+			fpe_set_frag(osi_core, l_core->fpe_afsz);
+		}
+	} else if (frag <= (hold * MTL_FPE_TUNE_FRAG_LOW)) {
+		l_core->fpe_quiet++;
+		if ((l_core->fpe_quiet >= MTL_FPE_TUNE_QUIET) &&
+		    (l_core->fpe_afsz > l_core->fpe_afsz_base)) {
+			l_core->fpe_quiet = 0U;
+			l_core->fpe_afsz--;
+			fpe_set_frag(osi_core, l_core->fpe_afsz);
+		}
+	} else {
+		/* Between thresholds, keep the fragment size */
+		l_core->fpe_quiet = 0U;
+	}
+}
+
+/**
+ * @brief hw_fpe_stats - Update FPE stats and tune fragment size.
+ *
+ * Algorithm:
+ * 1) Copy FPE counters from MMC into stats.
+ * 2) With auto tuning, adjust the min fragment size, see fpe_tune_frag().
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @note MMC counters should be read. see OSI_CMD_READ_MMC
+ */
+void hw_fpe_stats(struct osi_core_priv_data *const osi_core)
+{
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	const struct osi_mmc_counters *mmc = &osi_core->mmc;
+	struct osi_stats *stats = &osi_core->stats;
+
+	stats->fpe_tx_frag_n = mmc->mmc_tx_fpe_frag_cnt;
+	stats->fpe_hold_req_n = mmc->mmc_tx_fpe_hold_req_cnt;
+	stats->fpe_rx_frag_n = mmc->mmc_rx_fpe_fragment_cnt;
+	stats->fpe_rx_asm_ok_n = mmc->mmc_rx_packet_asm_ok_cnt;
+	stats->fpe_rx_asm_err_n = mmc->mmc_rx_packet_reass_err_cnt;
+	stats->fpe_rx_smd_err_n = mmc->mmc_rx_packet_smd_err_cnt;
+
+	if ((l_core->fpe_enabled == OSI_ENABLE) &&
+	    (l_core->fpe_frag_auto == OSI_ENABLE)) {
+		fpe_tune_frag(osi_core);
+	}
+
+	stats->fpe_frag_size = (l_core->fpe_enabled == OSI_ENABLE) ?
+			       (((nveu64_t)l_core->fpe_afsz + 1U) *
+				MTL_FPE_FRAG_UNIT) : 0U;
+}
+#endif /* !OSI_STRIPPED_LIB */
+
 /**
  * @brief enable_mtl_interrupts - Enable MTL interrupts
  *
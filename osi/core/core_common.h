@@ -30,8 +30,41 @@
 #define MAC_TCR_TSCFUPDT		OSI_BIT(1)
 #define MAC_TCR_TSCTRLSSR		OSI_BIT(9)
 #define MAC_PFR_PM			OSI_BIT(4)
+#define MAC_PFR_HUC			OSI_BIT(1)
+#define MAC_PFR_HMC			OSI_BIT(2)
+#define MAC_HTR_REG(x)			((0x0004U * (x)) + 0x0010U)
+/* MTL flow control thresholds in 512 byte units from FIFO full */
+#define MTL_FC_THRESH_MIN		3U
+#define MTL_FC_THRESH_MAX		64U
+/* L2 header, VLAN tags and FCS on top of MTU */
+#define MTL_FRAME_OVERHEAD		26U
+/* MAC_RxQ_Ctrl0 RXQEN field, same on EQOS/MGBE */
+#define MAC_RQC0R			0x00A0U
+#define MAC_RQC0R_RXQEN_MASK		0x3U
+/* MTL_RxQ_Debug, queue is empty with PRXQ and RXQSTS clear */
+#define MTL_RXQ_DBG_PRXQ		0x3FFF0000U
+#define MTL_RXQ_DBG_RXQSTS		0x30U
+#define MTL_RXQ_DBG_RXQSTS_FC		0x20U
+#define MTL_FC_THRESH_UNIT		512U
+/* MAC_Rx_Flow_Ctrl and MAC_Qx_Tx_Flow_Ctrl, same on EQOS/MGBE */
+#define MAC_RX_FLW_CTRL			0x0090U
+#define MAC_RX_FLW_CTRL_RFE		OSI_BIT(0)
+#define MAC_RX_FLW_CTRL_PFCE		OSI_BIT(8)
+#define MAC_QX_TX_FLW_CTRL(x)		((0x0004U * (x)) + 0x0070U)
+#define MAC_QX_TX_FLW_CTRL_TFE		OSI_BIT(1)
+#define MAC_QX_TX_FLW_CTRL_PT_SHIFT	16U
+#define MAC_QX_TX_FLW_CTRL_PT_MASK	0xFFFF0000U
+/* Only RX queues 0-7 have a MAC_Qx_Tx_Flow_Ctrl register */
+#define MAC_QX_TX_FLW_CTRL_MAX		8U
+#define MAC_PFC_PAUSE_QUANTA_DFLT	0xFFFFU
 #endif /* !OSI_STRIPPED_LIB */
 
+/* MAC_RxQ_Ctrl2/3 PSRQ fields, same on EQOS/MGBE */
+#define MAC_RQC2R(x)			((0x0004U * ((x) / 4U)) + 0x00A8U)
+#define MAC_RQC2R_PSRQ_MASK		0xFFU
+/* Byte lane of RX queue x in registers holding a field per 4 queues */
+#define RXQ_FIELD_SHIFT(x)		(((x) % 4U) * 8U)
+
 #define MTL_EST_ADDR_SHIFT			8
 #define MTL_EST_ADDR_MASK		(OSI_BIT(8) | OSI_BIT(9) | \
 					 OSI_BIT(10) | OSI_BIT(11) | \
@@ -52,6 +85,9 @@
 #define MTL_EST_SSWL			OSI_BIT(1)
 #define MTL_EST_QHLBF			OSI_BIT(3)
 #define MTL_EST_CTR_HIGH_MAX		0xFFU
+/* Time to program a GCL before the computed switch time */
+#define MTL_EST_SWAP_MARGIN_NS		10000000ULL
+#define MTL_EST_NSEC_PER_MSEC		1000000ULL
 #define MTL_EST_ITRE_CGCE			OSI_BIT(4)
 #define MTL_EST_ITRE_IEHS			OSI_BIT(3)
 #define MTL_EST_ITRE_IEHF			OSI_BIT(2)
@@ -69,6 +105,16 @@
 /* MTL FPE adv registers */
 #define MTL_FPE_ADV_HADV_MASK		(0xFFFFU)
 #define MTL_FPE_ADV_HADV_VAL		100U
+#define MTL_FPE_CTS_AFSZ		(OSI_BIT(0) | OSI_BIT(1))
+#define MTL_FPE_AFSZ_MAX		3U
+#define MTL_FPE_FRAG_UNIT		64U
+/* FPE auto tuning: TX fragments per hold request to step AFSZ up at,
+ * at or below which a read is quiet, and quiet reads to step it down */
+#define MTL_FPE_TUNE_FRAG_HIGH		4U
+#define MTL_FPE_TUNE_FRAG_LOW		2U
+#define MTL_FPE_TUNE_QUIET		4U
+/* Preamble/SMD, mCRC and IPG on top of a fragment */
+#define MTL_FPE_FRAG_OVERHEAD		24U
 #define DMA_MODE_SWR			OSI_BIT(0)
 #define MTL_QTOMR_FTQ			OSI_BIT(0)
 #define MTL_RXQ_OP_MODE_FEP		OSI_BIT(4)
@@ -76,6 +122,17 @@
 #define MAC_TCR_TSADDREG		OSI_BIT(5)
 #define MAC_PPS_CTL_PPSCTRL0		(OSI_BIT(3) | OSI_BIT(2) |\
 					OSI_BIT(1) | OSI_BIT(0))
+#ifndef OSI_STRIPPED_LIB
+#define MAC_PPS_CTL_PPSEN0		OSI_BIT(4)
+#define MAC_PPS_CTL_OUT_SHIFT		8U
+#define MAC_PPS_CTL_PPSCMD_MASK		0xFU
+#define MAC_PPS_CTL_TRGTMODSEL_SHIFT	5U
+#define MAC_PPS_CTL_TRGTMODSEL_MASK	0x3U
+#define MAC_PPS_CTL_TRGTMODSEL_PPS	0x3U
+#define MAC_PPS_CMD_START_TRAIN		0x2U
+#define MAC_PPS_CMD_STOP_IMMEDIATE	0x5U
+#define MAC_PPS_TTNSR_TRGTBUSY		OSI_BIT(31)
+#endif /* !OSI_STRIPPED_LIB */
 #define MAC_SSIR_SSINC_SHIFT		16U
 #define MAC_PFR_DAIF			OSI_BIT(3)
 #define MAC_PFR_DBF			OSI_BIT(5)
@@ -150,12 +207,28 @@ nve32_t hw_config_addend(struct osi_core_priv_data *const osi_core,
 			 const nveu32_t addend);
 void hw_config_tscr(struct osi_core_priv_data *const osi_core, const nveu32_t ptp_filter);
 void hw_config_ssir(struct osi_core_priv_data *const osi_core);
+#ifndef OSI_STRIPPED_LIB
+nve32_t hw_config_pps(struct osi_core_priv_data *const osi_core,
+		      const struct osi_pps_config *const pps);
+void hw_config_l2_hash(struct osi_core_priv_data *const osi_core,
+		       const nveu32_t *const htr, const nveu32_t *const old,
+		       nveu32_t nregs, nveu32_t pfr_bits);
+nve32_t hw_plan_mtl_fifo(struct osi_core_priv_data *const osi_core);
+nve32_t hw_remap_rxq(struct osi_core_priv_data *const osi_core,
+		     const struct osi_rxq_remap *const remap);
+void hw_fpe_stats(struct osi_core_priv_data *const osi_core);
+nve32_t hw_config_pfc(struct osi_core_priv_data *const osi_core,
+		      const struct osi_pfc_config *const pfc);
+void hw_pfc_stats(struct osi_core_priv_data *const osi_core);
+#endif /* !OSI_STRIPPED_LIB */
 nve32_t hw_ptp_tsc_capture(struct osi_core_priv_data *const osi_core,
 			   struct osi_core_ptp_tsc_data *data);
 nve32_t hw_config_mac_pkt_filter_reg(struct osi_core_priv_data *const osi_core,
 				     const struct osi_filter *filter);
 nve32_t hw_config_l3_l4_filter_enable(struct osi_core_priv_data *const osi_core,
 				      const nveu32_t filter_enb_dis);
+nve32_t hw_est_wait_swap(struct osi_core_priv_data *const osi_core,
+			 const nveu32_t timeout_ms);
 nve32_t hw_config_est(struct osi_core_priv_data *const osi_core,
 		      struct osi_est_config *const est);
 nve32_t hw_config_fpe(struct osi_core_priv_data *const osi_core,
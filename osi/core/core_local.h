@@ -43,6 +43,38 @@
  */
 #define MAX_TX_TS_CNT		(PKT_ID_CNT * OSI_MGBE_MAX_NUM_CHANS)
 
+/**
+ * @brief Number of slots in FRP ID index, power of 2 and at least twice
+ * the maximum number of FRP IDs so that probe chains stay short.
+ */
+#define FRP_IDX_SIZE		(OSI_FRP_MAX_ENTRY * 2U)
+
+/**
+ * @brief FNV-1a parameters for L3/L4 filter tuple hash
+ */
+#define L3L4_HASH_BASIS		0x811C9DC5U
+#define L3L4_HASH_PRIME		0x01000193U
+
+/**
+ * @brief VLAN set bitmap words and VLAN hash filter buckets
+ */
+#define VLAN_SET_WORDS		(VLAN_NUM_VID / 32U)
+#define VLAN_HASH_BUCKETS	16U
+
+/**
+ * @brief L2 address list perfect filter slot actions
+ */
+#define L2_SLOT_KEEP		0U
+#define L2_SLOT_DEL		1U
+#define L2_SLOT_ADD		2U
+
+/**
+ * @brief Largest RSS hash input (IPv6 addresses and L4 ports) and
+ * Toeplitz lookup table rows, one per input nibble
+ */
+#define RSS_HASH_IN_MAX		36U
+#define RSS_LUT_NIBBLES		(RSS_HASH_IN_MAX * 2U)
+
 /**
  * @brief FIFO size helper macro
  */
@@ -68,6 +100,12 @@
 #define DYNAMIC_CFG_FC_IDX	1U
 #define DYNAMIC_CFG_VLAN_IDX	5U
 #define DYNAMIC_CFG_EEE_IDX	6U
+#define DYNAMIC_CFG_PPS		OSI_BIT(11)
+#define DYNAMIC_CFG_PPS_IDX	11U
+#define DYNAMIC_CFG_RXQ_REMAP	OSI_BIT(12)
+#define DYNAMIC_CFG_RXQ_REMAP_IDX	12U
+#define DYNAMIC_CFG_PFC		OSI_BIT(13)
+#define DYNAMIC_CFG_PFC_IDX	13U
 #endif /* !OSI_STRIPPED_LIB */
 
 #define DYNAMIC_CFG_L3_L4_IDX	0U
@@ -204,6 +242,12 @@ struct core_ops {
 				const nveu32_t lb_mode);
 	/** Called to configure RSS for MAC */
 	nve32_t (*config_rss)(struct osi_core_priv_data *osi_core);
+	/** Called to write RSS table entries which differ from old */
+	nve32_t (*update_rss_table)(struct osi_core_priv_data *osi_core,
+				    const nveu32_t *const old);
+	/** Called to update RSS key, table and/or hash fields */
+	nve32_t (*update_rss)(struct osi_core_priv_data *osi_core,
+			      const nveu32_t upd);
 	/** Called to configure the PTP RX packets Queue */
 	nve32_t (*config_ptp_rxq)(struct osi_core_priv_data *const osi_core,
 				  const nveu32_t rxq_idx,
@@ -296,6 +340,48 @@ struct core_vlan {
 	nveu32_t used;
 };
 
+/**
+ * @brief FRP ID to FRP table position index slot
+ */
+struct core_frp_idx {
+	/** FRP ID */
+	nve32_t frp_id;
+	/** First FRP table entry used by the FRP ID */
+	nveu8_t start;
+	/** Number of FRP table entries used by the FRP ID, 0 if slot is free */
+	nveu8_t count;
+};
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief Flow steering rule storage structure
+ */
+struct core_flow {
+	/** Slot in use OSI_ENABLE else OSI_DISABLE */
+	nveu32_t used;
+	/** Flow steering rule */
+	struct osi_flow_spec spec;
+};
+#endif /* !OSI_STRIPPED_LIB */
+
+/**
+ * @brief EST GCL memory bank content as last programmed
+ */
+struct core_est_bank {
+	/** Bank content is known OSI_ENABLE, else OSI_DISABLE */
+	nveu32_t valid;
+	/** Base time, index 0 for nsec, index 1 for sec */
+	nveu32_t btr[2];
+	/** Cycle time, index 0 for nsec, index 1 for sec */
+	nveu32_t ctr[2];
+	/** Time extension */
+	nveu32_t ter;
+	/** GCL length */
+	nveu32_t llr;
+	/** GCL entries */
+	nveu32_t gcl[OSI_GCL_SIZE_256];
+};
+
 /**
  * @brief L2 filter dynamic config storage structure
  */
@@ -332,6 +418,16 @@ struct dynamic_cfg {
 	struct osi_filter l2_filter;
 	/** L2 filter configuration */
 	struct core_l2 l2[EQOS_MAX_MAC_ADDRESS_FILTER];
+#ifndef OSI_STRIPPED_LIB
+	/** Flexible PPS output configuration */
+	struct osi_pps_config pps[OSI_MAX_PPS_OUT];
+	/** RX queue remapping per MTL queue */
+	struct osi_rxq_remap rxq_remap[OSI_MGBE_MAX_NUM_QUEUES];
+	/** Bitmap of MTL queues with rxq_remap[] set */
+	nveu32_t rxq_remap_mask;
+	/** PFC configuration */
+	struct osi_pfc_config pfc;
+#endif /* !OSI_STRIPPED_LIB */
 };
 
 /**
@@ -372,10 +468,99 @@ struct core_local {
 	nveu32_t m2m_tsync;
 	/** control pps output signal */
 	nveu32_t pps_freq;
+	/** Addend change per ppb in 32.32 fixed point,
+	 * (default_addend << 32) / OSI_NSEC_PER_SEC */
+	nveu64_t addend_scale;
 	/** Time interval mask for GCL entry */
 	nveu32_t ti_mask;
+	/** FRP ID index into osi_core->frp_table, open addressed */
+	struct core_frp_idx frp_idx[FRP_IDX_SIZE];
+	/** FRP transaction started OSI_ENABLE else OSI_DISABLE */
+	nveu32_t frp_txn;
+	/** A command in current FRP transaction failed */
+	nveu32_t frp_txn_err;
+	/** FRP table count saved on FRP transaction start */
+	nveu32_t frp_txn_cnt;
+	/** FRP table saved on FRP transaction start */
+	struct osi_core_frp_entry frp_txn_table[OSI_FRP_MAX_ENTRY];
+#ifndef OSI_STRIPPED_LIB
+	/** Flow steering rules */
+	struct core_flow flows[OSI_MAX_FLOWS];
+	/** Flow steering rules saved on FRP transaction start */
+	struct core_flow frp_txn_flows[OSI_MAX_FLOWS];
+#endif /* !OSI_STRIPPED_LIB */
+	/** FRP table compiled into HW instruction program */
+	struct osi_core_frp_data frp_prog[OSI_FRP_MAX_ENTRY];
+	/** Number of instructions in frp_prog */
+	nveu32_t frp_prog_cnt;
+	/** FRP instruction table as last programmed into HW */
+	struct osi_core_frp_data frp_hw[OSI_FRP_MAX_ENTRY];
+	/** FRP NVE last programmed into HW */
+	nveu32_t frp_hw_nve;
+	/** frp_hw is in sync with HW OSI_ENABLE else OSI_DISABLE */
+	nveu32_t frp_hw_valid;
+	/** EST GCL memory banks as last programmed, indexed by SWOL */
+	struct core_est_bank est_bank[2];
 	/** Hardware dynamic configuration context */
 	struct dynamic_cfg cfg;
+	/** Bitmap of cfg.l3_l4[] slots in use, clear bits are free slots */
+	nveu32_t l3l4_used;
+	/** Tuple hash of each used cfg.l3_l4[] slot */
+	nveu32_t l3l4_hash[OSI_MGBE_MAX_L3_L4_FILTER];
+#ifndef OSI_STRIPPED_LIB
+	/** L2 DA hash table as programmed into HW */
+	nveu32_t l2_hash[EQOS_MAX_HTR_REGS];
+	/** MAC_PFR_HMC/MAC_PFR_HUC bits programmed along with l2_hash */
+	nveu32_t l2_hash_pfr;
+	/** Bitmap of VIDs in VLAN filter set */
+	nveu32_t vlan_set[VLAN_SET_WORDS];
+	/** Bitmap of VIDs programmed in HW VLAN filters */
+	nveu32_t vlan_hw[VLAN_SET_WORDS];
+	/** HW VLAN filters a failed sync did not write */
+	nveu64_t vlan_dirty;
+	/** Number of VIDs of the set in each VLAN hash bucket */
+	nveu16_t vlan_hash_cnt[VLAN_HASH_BUCKETS];
+	/** RSS table index to start the next bucket move search from */
+	nveu32_t rss_cursor;
+	/** Toeplitz lookup table per input nibble position and value */
+	nveu32_t rss_lut[RSS_LUT_NIBBLES][16];
+	/** RSS key rss_lut was built for */
+	nveu8_t rss_lut_key[OSI_RSS_HASH_KEY_SIZE];
+	/** rss_lut matches rss_lut_key OSI_ENABLE else OSI_DISABLE */
+	nveu32_t rss_lut_valid;
+	/** MTL FIFO plan in use OSI_ENABLE, fixed layout OSI_DISABLE */
+	nveu32_t mtl_fifo_auto;
+	/** Planned RX FIFO size per MTL queue, in FIFO_SZ() encoding */
+	nveu32_t mtl_rx_fifo[OSI_MGBE_MAX_NUM_QUEUES];
+	/** Planned TX FIFO size per MTL queue, in FIFO_SZ() encoding */
+	nveu32_t mtl_tx_fifo[OSI_MGBE_MAX_NUM_QUEUES];
+	/** Planned RFA per MTL queue, FIFO full minus (value + 2) * 512 bytes */
+	nveu32_t mtl_rfa[OSI_MGBE_MAX_NUM_QUEUES];
+	/** Planned RFD per MTL queue, same encoding as mtl_rfa */
+	nveu32_t mtl_rfd[OSI_MGBE_MAX_NUM_QUEUES];
+	/** Link speed in Mbps last set with hw_set_speed(), 0 if unknown */
+	nveu32_t link_speed;
+	/** CBS configuration credits are derived from on speed change */
+	struct osi_cbs_config cbs;
+	/** cbs is set OSI_ENABLE else OSI_DISABLE */
+	nveu32_t cbs_valid;
+	/** Preemption enabled on any queue OSI_ENABLE else OSI_DISABLE */
+	nveu32_t fpe_enabled;
+	/** FPE fragment size auto tuning OSI_ENABLE else OSI_DISABLE */
+	nveu32_t fpe_frag_auto;
+	/** FPE AFSZ in use, min non-final fragment is (value + 1) * 64 bytes */
+	nveu32_t fpe_afsz;
+	/** FPE AFSZ configured, auto tuning never goes below it */
+	nveu32_t fpe_afsz_base;
+	/** Consecutive stats reads with low TX fragmentation */
+	nveu32_t fpe_quiet;
+	/** MMC TX fragment count at FPE enable or last stats read */
+	nveu64_t fpe_frag_last;
+	/** MMC TX hold request count at FPE enable or last stats read */
+	nveu64_t fpe_hold_last;
+#endif /* !OSI_STRIPPED_LIB */
+	/** Bitmap of MGBE indirect access ports with an operation in flight */
+	nveu32_t indir_pending;
 	/** Hardware dynamic configuration state */
 	nveu32_t state;
 	/** XPCS Lane bringup/Block lock status */
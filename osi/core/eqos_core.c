@@ -384,10 +384,22 @@ static nve32_t eqos_configure_mtl_queue(struct osi_core_priv_data *const osi_cor
 	nveu32_t que_idx = (q_inx & 0x7U);
 	nveu32_t rx_fifo_sz_t = 0U;
 	nveu32_t tx_fifo_sz_t = 0U;
+	nveu32_t rfa = rfd_rfa[que_idx];
+	nveu32_t rfd = rfd_rfa[que_idx];
 	nveu32_t value = 0;
 	nve32_t ret = 0;
 
 	tx_fifo_sz_t = tx_fifo_sz[l_macv][que_idx];
+	rx_fifo_sz_t = rx_fifo_sz[l_macv][que_idx];
+#ifndef OSI_STRIPPED_LIB
+	/* FIFO layout planned from queue profiles */
+	if (l_core->mtl_fifo_auto == OSI_ENABLE) {
+		tx_fifo_sz_t = l_core->mtl_tx_fifo[que_idx];
+		rx_fifo_sz_t = l_core->mtl_rx_fifo[que_idx];
+		rfa = l_core->mtl_rfa[que_idx];
+		rfd = l_core->mtl_rfd[que_idx];
+	}
+#endif /* !OSI_STRIPPED_LIB */
 
 	ret = hw_flush_mtl_tx_queue(osi_core, que_idx);
 	if (ret < 0) {
@@ -405,7 +417,6 @@ static nve32_t eqos_configure_mtl_queue(struct osi_core_priv_data *const osi_cor
 	value = osi_readla(osi_core, (nveu8_t *)osi_core->base +
 			   EQOS_MTL_CHX_RX_OP_MODE(que_idx));
 
-	rx_fifo_sz_t = rx_fifo_sz[l_macv][que_idx];
 	value |= (rx_fifo_sz_t << EQOS_MTL_RXQ_SIZE_SHIFT);
 	/* Enable Store and Forward mode */
 	value |= EQOS_MTL_RSF;
@@ -417,9 +428,9 @@ static nve32_t eqos_configure_mtl_queue(struct osi_core_priv_data *const osi_cor
 	value &= ~EQOS_MTL_RXQ_OP_MODE_RFD_MASK;
 	value &= ~EQOS_MTL_RXQ_OP_MODE_RFA_MASK;
 	value |= EQOS_MTL_RXQ_OP_MODE_EHFC;
-	value |= (rfd_rfa[que_idx] << EQOS_MTL_RXQ_OP_MODE_RFD_SHIFT) &
+	value |= (rfd << EQOS_MTL_RXQ_OP_MODE_RFD_SHIFT) &
 		  EQOS_MTL_RXQ_OP_MODE_RFD_MASK;
-	value |= (rfd_rfa[que_idx] << EQOS_MTL_RXQ_OP_MODE_RFA_SHIFT) &
+	value |= (rfa << EQOS_MTL_RXQ_OP_MODE_RFA_SHIFT) &
 		  EQOS_MTL_RXQ_OP_MODE_RFA_MASK;
 	osi_writela(osi_core, value, (nveu8_t *)osi_core->base + EQOS_MTL_CHX_RX_OP_MODE(que_idx));
 
@@ -1403,12 +1414,20 @@ static void eqos_handle_mac_fpe_intrs(struct osi_core_priv_data *osi_core)
 		val &= ~EQOS_MAC_FPE_CTS_RRSP;
 		val &= ~EQOS_MAC_FPE_CTS_TVER;
 		osi_core->fpe_ready = OSI_ENABLE;
+#ifndef OSI_STRIPPED_LIB
+		osi_core->stats.fpe_verify_ok_n =
+			osi_update_stats_counter(osi_core->stats.fpe_verify_ok_n, 1UL);
+#endif /* !OSI_STRIPPED_LIB */
 		val |= EQOS_MAC_FPE_CTS_EFPE;
 	}
 
 	if ((val & EQOS_MAC_FPE_CTS_TRSP) == EQOS_MAC_FPE_CTS_TRSP) {
 		/* TX response packet sucessful */
 		osi_core->fpe_ready = OSI_ENABLE;
+#ifndef OSI_STRIPPED_LIB
+		osi_core->stats.fpe_verify_ok_n =
+			osi_update_stats_counter(osi_core->stats.fpe_verify_ok_n, 1UL);
+#endif /* !OSI_STRIPPED_LIB */
 		/* Enable frame preemption */
 		val &= ~EQOS_MAC_FPE_CTS_TRSP;
 		val &= ~EQOS_MAC_FPE_CTS_TVER;
@@ -3790,6 +3809,8 @@ static nve32_t eqos_get_hw_features(struct osi_core_priv_data *const osi_core,
 			    EQOS_MAC_HFR1_ADDR64_MASK);
 	hw_feat->dcb_en = ((mac_hfr1 >> EQOS_MAC_HFR1_DCBEN_SHIFT) &
 			   EQOS_MAC_HFR1_DCBEN_MASK);
+	/* EQOS has no PFC feature bit, PFC is part of DCB */
+	hw_feat->pfc_en = hw_feat->dcb_en;
 	hw_feat->sph_en = ((mac_hfr1 >> EQOS_MAC_HFR1_SPHEN_SHIFT) &
 			   EQOS_MAC_HFR1_SPHEN_MASK);
 	hw_feat->tso_en = ((mac_hfr1 >> EQOS_MAC_HFR1_TSOEN_SHIFT) &
@@ -4110,6 +4131,42 @@ static nve32_t eqos_config_rss(struct osi_core_priv_data *osi_core)
 
 	return -1;
 }
+
+/**
+ * @brief eqos_update_rss_table - Update RSS table entries
+ *
+ * @param[in] osi_core: OSI core private data.
+ * @param[in] old: RSS table as programmed in HW.
+ *
+ * @retval -1 Always
+ */
+static nve32_t eqos_update_rss_table(struct osi_core_priv_data *osi_core,
+				     const nveu32_t *const old)
+{
+	(void) old;
+	OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+		     "RSS not supported by EQOS\n", 0ULL);
+
+	return -1;
+}
+
+/**
+ * @brief eqos_update_rss - Update parts of RSS configuration
+ *
+ * @param[in] osi_core: OSI core private data.
+ * @param[in] upd: OSI_RSS_UPD_* bits.
+ *
+ * @retval -1 Always
+ */
+static nve32_t eqos_update_rss(struct osi_core_priv_data *osi_core,
+			       const nveu32_t upd)
+{
+	(void) upd;
+	OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+		     "RSS not supported by EQOS\n", 0ULL);
+
+	return -1;
+}
 #endif /* !OSI_STRIPPED_LIB */
 
 #if defined(MACSEC_SUPPORT) && !defined(OSI_STRIPPED_LIB)
@@ -4256,6 +4313,8 @@ void eqos_init_core_ops(struct core_ops *ops)
 	ops->set_mdc_clk_rate = eqos_set_mdc_clk_rate;
 	ops->config_mac_loopback = eqos_config_mac_loopback;
 	ops->config_rss = eqos_config_rss;
+	ops->update_rss_table = eqos_update_rss_table;
+	ops->update_rss = eqos_update_rss;
 	ops->config_ptp_rxq = eqos_config_ptp_rxq;
 #endif /* !OSI_STRIPPED_LIB */
 #ifdef HSI_SUPPORT
@@ -249,6 +249,7 @@
 #define EQOS_MAC_EXTR			0x0004
 #define EQOS_MAC_VLAN_TAG		0x0050
 #define EQOS_MAC_VLANTIR		0x0060
+#define EQOS_MAC_TXQ_PRTY_MAP0		0x0098
 #define EQOS_MAC_RQC0R			0x00A0
 #define EQOS_MAC_RQC1R			0x00A4
 #define EQOS_MAC_RQC2R			0x00A8
@@ -288,6 +289,10 @@
 #define EQOS_MAC_STNSUR			0x0B14
 #define EQOS_MAC_TAR			0x0B18
 #define EQOS_MAC_PPS_CTL		0x0B70
+#define EQOS_MAC_PPS_TTSR(x)		((0x0010U * (x)) + 0x0B80U)
+#define EQOS_MAC_PPS_TTNSR(x)		((0x0010U * (x)) + 0x0B84U)
+#define EQOS_MAC_PPS_INTERVAL(x)	((0x0010U * (x)) + 0x0B88U)
+#define EQOS_MAC_PPS_WIDTH(x)		((0x0010U * (x)) + 0x0B8CU)
 #define EQOS_DMA_BMR			0x1000
 #define EQOS_DMA_SBUS			0x1004
 #define EQOS_DMA_ISR			0x1008
@@ -306,6 +311,7 @@
 #define EQOS_MTL_CHX_TX_OP_MODE(x)	((0x0040U * (x)) + 0x0D00U)
 #define EQOS_MTL_TXQ_QW(x)		((0x0040U * (x)) + 0x0D18U)
 #define EQOS_MTL_CHX_RX_OP_MODE(x)	((0x0040U * (x)) + 0x0D30U)
+#define EQOS_MTL_CHX_RX_DEBUG(x)	((0x0040U * (x)) + 0x0D38U)
 /** @} */
 
 /**
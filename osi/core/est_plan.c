@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef OSI_STRIPPED_LIB
+#include "../osi/common/common.h"
+#include "est_plan.h"
+
+/**
+ * @brief est_plan_frame_ns - Wire time of a max size frame.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] speed: Link speed in Mbps.
+ *
+ * @retval Frame time in ns
+ */
+static nveu64_t est_plan_frame_ns(const struct osi_core_priv_data *const osi_core,
+				  nveu32_t speed)
+{
+	nveu64_t mtu = osi_core->mtu;
+
+	if ((mtu < OSI_DFLT_MTU_SIZE) || (mtu > OSI_MAX_MTU_SIZE)) {
+		mtu = OSI_DFLT_MTU_SIZE;
+	}
+
+	/* bits * 1000 / Mbps, rounded up */
+	return (((mtu + EST_PLAN_FRAME_OVERHEAD) * 8000ULL) + speed - 1U) /
+	       speed;
+}
+
+/**
+ * @brief est_plan_add - Append gate window to the GCL.
+ *
+ * Algorithm: Split the window into entries of at most the time interval
+ *	HW can hold.
+ *
+ * @param[in] l_core: Core local data structure.
+ * @param[in, out] est: EST configuration, llr is the number of entries.
+ * @param[in] gates: Gates open in the window.
+ * @param[in] win: Window length in ns.
+ *
+ * @retval 0 on success.
+ * @retval -1 if GCL depth is exceeded.
+ */
+static nve32_t est_plan_add(const struct core_local *const l_core,
+			    struct osi_est_config *const est,
+			    nveu32_t gates, nveu64_t win)
+{
+	nveu32_t depth = (l_core->gcl_dep < OSI_GCL_SIZE_256) ?
+			 l_core->gcl_dep : OSI_GCL_SIZE_256;
+	nveu64_t t = win;
+	nveu32_t ti;
+	nve32_t ret = 0;
+
+	while (t > 0U) {
+		if (est->llr >= depth) {
+			ret = -1;
+			goto done;
+		}
+
+		ti = (t > l_core->ti_mask) ? l_core->ti_mask : (nveu32_t)t;
+		est->gcl[est->llr] = (gates * (l_core->ti_mask + 1U)) | ti;
+		est->llr++;
+		t -= ti;
+	}
+done:
+	return ret;
+}
+
+/**
+ * @brief est_plan_lat_key - Sort key of a traffic class, tightest latency
+ *	bound first and unbounded classes last.
+ *
+ * @param[in] tc: Traffic class requirements.
+ *
+ * @retval Sort key
+ */
+static inline nveu32_t est_plan_lat_key(const struct osi_est_plan_tc *const tc)
+{
+	return (tc->max_lat_ns == 0U) ? UINT_MAX : tc->max_lat_ns;
+}
+
+nve32_t est_plan(struct osi_core_priv_data *const osi_core,
+		 struct osi_est_plan *const plan,
+		 struct osi_est_config *const est)
+{
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct osi_est_plan_tc *tc;
+	nveu32_t order[OSI_MAX_TC_NUM];
+	nveu64_t frame, cycle, win, need;
+	nveu64_t used = 0U;
+	nveu32_t nres = 0U, be_mask = 0U, all_mask = 0U;
+	nveu32_t min_lat = 0U;
+	nveu32_t i, j, k;
+	nve32_t ret = -1;
+
+	if ((l_core->ti_mask == 0U) || (l_core->gcl_dep == 0U)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "EST not supported\n", 0ULL);
+		goto fail;
+	}
+
+	if ((plan->num_tc == 0U) || (plan->num_tc > OSI_MAX_TC_NUM) ||
+	    ((plan->speed != (nveu32_t)OSI_SPEED_10) &&
+	     (plan->speed != (nveu32_t)OSI_SPEED_100) &&
+	     (plan->speed != (nveu32_t)OSI_SPEED_1000) &&
+	     (plan->speed != (nveu32_t)OSI_SPEED_2500) &&
+	     (plan->speed != (nveu32_t)OSI_SPEED_5000) &&
+	     (plan->speed != (nveu32_t)OSI_SPEED_10000))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "EST plan: invalid TC count or speed\n",
+			     (nveul64_t)plan->speed);
+		goto fail;
+	}
+
+	for (i = 0U; i < plan->num_tc; i++) {
+		tc = &plan->tc[i];
+		tc->window_ns = 0U;
+		tc->lat_ns = 0U;
+		if (tc->bw > OSI_EST_PLAN_BW_MAX) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "EST plan: invalid bandwidth\n",
+				     (nveul64_t)i);
+			goto fail;
+		}
+
+		all_mask |= OSI_BIT(i);
+		if ((tc->bw == 0U) && (tc->max_lat_ns == 0U)) {
+			be_mask |= OSI_BIT(i);
+			continue;
+		}
+
+		if ((tc->max_lat_ns != 0U) &&
+		    ((min_lat == 0U) || (tc->max_lat_ns < min_lat))) {
+			min_lat = tc->max_lat_ns;
+		}
+
+		/* Insertion sort, tightest latency bound first */
+		j = nres;
+		while ((j > 0U) && (est_plan_lat_key(&plan->tc[order[j - 1U]]) >
+				    est_plan_lat_key(tc))) {
+			order[j] = order[j - 1U];
+			j--;
+		}
+		order[j] = i;
+		nres++;
+	}
+
+	cycle = plan->cycle_ns;
+	if (cycle == 0U) {
+		cycle = (min_lat != 0U) ? min_lat : OSI_EST_PLAN_DFLT_CYCLE_NS;
+	}
+	frame = est_plan_frame_ns(osi_core, plan->speed);
+
+	for (k = 0U; k < nres; k++) {
+		tc = &plan->tc[order[k]];
+		win = (cycle * tc->bw) / OSI_EST_PLAN_BW_MAX;
+		/* A frame queued as the window closes waits cycle - window */
+		if ((tc->max_lat_ns != 0U) && (tc->max_lat_ns < (cycle + frame))) {
+			need = (cycle + frame) - tc->max_lat_ns;
+			win = (need > win) ? need : win;
+		}
+		win = (frame > win) ? frame : win;
+
+		used += win;
+		if (used > cycle) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "EST plan: TC doesn't fit in cycle\n",
+				     (nveul64_t)order[k]);
+			goto fail;
+		}
+		tc->window_ns = (nveu32_t)win;
+		tc->lat_ns = (nveu32_t)((cycle - win) + frame);
+	}
+
+	if ((be_mask != 0U) && ((cycle - used) < frame)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "EST plan: no time left for best effort TCs\n",
+			     (nveul64_t)(cycle - used));
+		goto fail;
+	}
+
+	for (i = 0U; i < plan->num_tc; i++) {
+		if ((be_mask & OSI_BIT(i)) != 0U) {
+			plan->tc[i].window_ns = (nveu32_t)(cycle - used);
+			plan->tc[i].lat_ns = (nveu32_t)(used + frame);
+		}
+	}
+
+	(void)osi_memset(est, 0U, sizeof(struct osi_est_config));
+	est->en_dis = OSI_ENABLE;
+	est->ctr[0] = (nveu32_t)(cycle % OSI_NSEC_PER_SEC);
+	est->ctr[1] = (nveu32_t)(cycle / OSI_NSEC_PER_SEC);
+	ret = 0;
+	for (k = 0U; (k < nres) && (ret == 0); k++) {
+		ret = est_plan_add(l_core, est, OSI_BIT(order[k]),
+				   plan->tc[order[k]].window_ns);
+	}
+
+	/* Rest of the cycle all gates open */
+	if (ret == 0) {
+		ret = est_plan_add(l_core, est, all_mask, cycle - used);
+	}
+
+	if (ret < 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "EST plan: GCL depth exceeded\n",
+			     (nveul64_t)est->llr);
+	}
+fail:
+	return ret;
+}
+#endif /* !OSI_STRIPPED_LIB */
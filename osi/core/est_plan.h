@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef EST_PLAN_H
+#define EST_PLAN_H
+
+#include <osi_common.h>
+#include <osi_core.h>
+#include "core_local.h"
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @addtogroup EST-PLAN EST schedule planning defines
+ *
+ * @brief Frame overhead on top of MTU: L2 header, VLAN tag, FCS,
+ *	preamble/SFD and IPG
+ * @{
+ */
+#define EST_PLAN_FRAME_OVERHEAD	42U
+/** @} */
+
+/**
+ * @brief est_plan - Generate EST GCL from traffic class requirements.
+ *
+ * Algorithm: Give each class with a bandwidth or latency requirement an
+ *	exclusive gate window per cycle, large enough for its bandwidth
+ *	share, its latency bound and one max size frame. Remaining time is
+ *	a window with all gates open. No HW access.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in, out] plan: Requirements in, windows and latencies out.
+ * @param[out] est: EST configuration, base time left 0.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure, or if requirements can't be met.
+ */
+nve32_t est_plan(struct osi_core_priv_data *const osi_core,
+		 struct osi_est_plan *const plan,
+		 struct osi_est_config *const est);
+#endif /* !OSI_STRIPPED_LIB */
+#endif /* EST_PLAN_H */
@@ -47,10 +47,81 @@ static void frp_entry_copy(struct osi_core_frp_entry *dst,
 	dst->data.dma_chsel = src->data.dma_chsel;
 }
 
+/**
+ * @brief frp_idx_slot - Find FRP ID index slot
+ *
+ * Algorithm: Linear probe FRP ID index from the hashed slot until the
+ *	FRP ID or a free slot is found.
+ *
+ * @param[in] l_core: Core local private data structure.
+ * @param[in] frp_id: FRP ID to find.
+ *
+ * @retval Pointer to slot holding frp_id, or free slot to insert it.
+ */
+static struct core_frp_idx *frp_idx_slot(struct core_local *const l_core,
+					 nve32_t frp_id)
+{
+	nveu32_t slot = (nveu32_t)frp_id & (FRP_IDX_SIZE - 1U);
+	struct core_frp_idx *idx = &l_core->frp_idx[slot];
+
+	while ((idx->count != 0U) && (idx->frp_id != frp_id)) {
+		slot = (slot + 1U) & (FRP_IDX_SIZE - 1U);
+		idx = &l_core->frp_idx[slot];
+	}
+
+	return idx;
+}
+
+/**
+ * @brief frp_idx_insert - Add FRP ID into FRP ID index
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] frp_id: FRP ID to add.
+ * @param[in] start: First FRP table entry of frp_id.
+ * @param[in] count: Number of FRP table entries of frp_id.
+ */
+static void frp_idx_insert(struct osi_core_priv_data *const osi_core,
+			   nve32_t frp_id, nveu8_t start, nveu8_t count)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct core_frp_idx *idx = frp_idx_slot(l_core, frp_id);
+
+	idx->frp_id = frp_id;
+	idx->start = start;
+	idx->count = count;
+}
+
+/**
+ * @brief frp_idx_rebuild - Rebuild FRP ID index from FRP table
+ *
+ * Algorithm: Clear the FRP ID index and add every run of consecutive
+ *	FRP table entries with same FRP ID.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ */
+static void frp_idx_rebuild(struct osi_core_priv_data *const osi_core)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t i, start = 0U;
+
+	osi_memset(l_core->frp_idx, 0U, sizeof(l_core->frp_idx));
+
+	for (i = 1U; i <= osi_core->frp_cnt; i++) {
+		if ((i == osi_core->frp_cnt) ||
+		    (osi_core->frp_table[i].frp_id !=
+		     osi_core->frp_table[start].frp_id)) {
+			frp_idx_insert(osi_core,
+				       osi_core->frp_table[start].frp_id,
+				       (nveu8_t)start, (nveu8_t)(i - start));
+			start = i;
+		}
+	}
+}
+
 /**
  * @brief frp_entry_find - Find FRP entry in table
  *
- * Algorithm: Parse FRP table for given ID and bookmark
+ * Algorithm: Look up FRP ID index for given ID and return
  * start position and count of entries for a given ID.
  *
  * @param[in] osi_core: OSI core private data structure.
@@ -66,29 +137,14 @@ static nve32_t frp_entry_find(struct osi_core_priv_data *const osi_core,
 			      nveu8_t *start,
 			      nveu8_t *no_entries)
 {
-	nveu8_t count = OSI_NONE, found = OSI_NONE;
-	struct osi_core_frp_entry *entry = OSI_NULL;
-	nve32_t ret = 0;
-
-	/* Parse the FRP table for give frp_id */
-	for (count = 0U; count < osi_core->frp_cnt; count++) {
-		entry = &osi_core->frp_table[count];
-		if (entry->frp_id == frp_id) {
-			/* Entry found break */
-			if (found == OSI_NONE) {
-				*start = count;
-				*no_entries = 1;
-				found = OSI_ENABLE;
-			} else {
-				/* Increment entries */
-				*no_entries =  (nveu8_t)(*no_entries + 1U);
-			}
-		}
-	}
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct core_frp_idx *idx = frp_idx_slot(l_core, frp_id);
+	nve32_t ret = -1;
 
-	if (found == OSI_NONE) {
-		/* No entry found return error */
-		ret = -1;
+	if (idx->count != 0U) {
+		*start = idx->start;
+		*no_entries = idx->count;
+		ret = 0;
 	}
 
 	return ret;
@@ -368,10 +424,286 @@ done:
 	return ret;
 }
 
+/**
+ * @brief frp_data_equal - Compare two FRP instructions
+ *
+ * @param[in] a: First FRP instruction.
+ * @param[in] b: Second FRP instruction.
+ *
+ * @retval OSI_ENABLE if both instructions program identical HW words.
+ * @retval OSI_DISABLE otherwise.
+ */
+static nveu32_t frp_data_equal(const struct osi_core_frp_data *const a,
+			       const struct osi_core_frp_data *const b)
+{
+	nveu32_t ret = OSI_DISABLE;
+
+	if ((a->match_data == b->match_data) &&
+	    (a->match_en == b->match_en) &&
+	    (a->accept_frame == b->accept_frame) &&
+	    (a->reject_frame == b->reject_frame) &&
+	    (a->inverse_match == b->inverse_match) &&
+	    (a->next_ins_ctrl == b->next_ins_ctrl) &&
+	    (a->frame_offset == b->frame_offset) &&
+	    (a->ok_index == b->ok_index) &&
+	    (a->dma_chsel == b->dma_chsel)) {
+		ret = OSI_ENABLE;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief frp_hw_entry_write - Write one FRP instruction if it changed
+ *
+ * Algorithm: Compare the instruction against the HW shadow copy and
+ * program it only when it differs, shadow is updated on success.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] ops_p: Core operations data structure.
+ * @param[in] pos: FRP instruction table index.
+ * @param[in] data: FRP instruction to be programmed.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t frp_hw_entry_write(struct osi_core_priv_data *const osi_core,
+				  struct core_ops *const ops_p,
+				  nveu32_t pos,
+				  struct osi_core_frp_data *const data)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nve32_t ret = 0;
+
+	if (frp_data_equal(&l_core->frp_hw[pos], data) == OSI_ENABLE) {
+		goto done;
+	}
+
+	ret = ops_p->update_frp_entry(osi_core, pos, data);
+	if (ret < 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+			"Fail to update FRP entry\n",
+			pos);
+		goto done;
+	}
+
+	l_core->frp_hw[pos] = *data;
+
+done:
+	return ret;
+}
+
+/**
+ * @brief frp_rule_end - Find end of the FRP rule starting at given index
+ *
+ * @param[in] table: FRP table.
+ * @param[in] start: Index of first instruction of the rule.
+ * @param[in] frp_cnt: Number of entries in FRP table.
+ *
+ * @retval Index just past the last instruction with the same FRP ID.
+ */
+static nveu32_t frp_rule_end(const struct osi_core_frp_entry *const table,
+			     nveu32_t start, nveu32_t frp_cnt)
+{
+	nveu32_t i = start + 1U;
+
+	while ((i < frp_cnt) && (table[i].frp_id == table[start].frp_id)) {
+		i++;
+	}
+
+	return i;
+}
+
+/**
+ * @brief frp_jump_out - Check for a rule prefix instruction
+ *
+ * Algorithm: A prefix instruction is an inverse match with NIC set and OKI
+ *	just past its own rule, which is not the last instruction of the rule.
+ *	A frame that does not match it skips the rest of the rule, a frame
+ *	that matches falls through to the next instruction.
+ *
+ * @param[in] data: FRP instruction.
+ * @param[in] pos: FRP table index of the instruction.
+ * @param[in] end: Index just past the last instruction of the rule.
+ *
+ * @retval OSI_ENABLE if instruction is a rule prefix instruction.
+ * @retval OSI_DISABLE otherwise.
+ */
+static nveu32_t frp_jump_out(const struct osi_core_frp_data *const data,
+			     nveu32_t pos, nveu32_t end)
+{
+	nveu32_t ret = OSI_DISABLE;
+
+	if (((pos + 1U) < end) &&
+	    (data->inverse_match == OSI_ENABLE) &&
+	    (data->next_ins_ctrl == OSI_ENABLE) &&
+	    ((nveu32_t)data->ok_index == end)) {
+		ret = OSI_ENABLE;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief frp_match_equal - Compare two FRP instructions ignoring OKI
+ *
+ * @param[in] a: First FRP instruction.
+ * @param[in] b: Second FRP instruction.
+ *
+ * @retval OSI_ENABLE if both instructions match and act the same way.
+ * @retval OSI_DISABLE otherwise.
+ */
+static nveu32_t frp_match_equal(const struct osi_core_frp_data *const a,
+				const struct osi_core_frp_data *const b)
+{
+	struct osi_core_frp_data tmp = *b;
+
+	tmp.ok_index = a->ok_index;
+
+	return frp_data_equal(a, &tmp);
+}
+
+/**
+ * @brief frp_compile - Compile FRP table into HW instruction program.
+ *
+ * Algorithm:
+ * 1) Table is walked rule by rule, a rule being the consecutive entries
+ *    of one FRP ID. Rule order is kept, it decides which rule wins.
+ * 2) Leading prefix instructions of a rule, see frp_jump_out(), which are
+ *    equal to the prefix instructions of the rule before are not emitted
+ *    again. The first emitted copy has its OKI moved past the last rule
+ *    sharing it, so a frame which does not match the shared prefix skips
+ *    all of these rules, while a frame which matches the prefix but not
+ *    the rest of one rule continues with the next rule after the prefix.
+ *    Flow steering rules with the same EtherType or VLAN share those
+ *    words this way. The last instruction of a rule is never shared, and
+ *    an instruction some other link points into is never dropped.
+ * 3) OKI of every link is moved from table index to program index, OKI
+ *    beyond the table is mapped to the XDCS BYPASS rule.
+ * 4) Program plus BYPASS rule is checked against HW FRP capacity.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] table: FRP table to compile.
+ * @param[in] frp_cnt: Number of entries in FRP table.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t frp_compile(struct osi_core_priv_data *const osi_core,
+			   const struct osi_core_frp_entry *const table,
+			   nveu32_t frp_cnt)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct osi_core_frp_data *prog = l_core->frp_prog;
+	nveu8_t map[OSI_FRP_MAX_ENTRY + 1U];
+	nveu32_t link[OSI_FRP_MAX_ENTRY / 32U] = {0U};
+	nveu32_t chain[FRP_PREFIX_MAX];
+	nveu32_t max = OSI_FRP_MAX_ENTRY;
+	nveu32_t depth = 0U, n = 0U;
+	nveu32_t i, k, d, s, e, oki;
+	nve32_t ret = 0;
+
+	if ((osi_core->mac == OSI_MAC_HW_MGBE) &&
+	    (osi_core->hw_feature != OSI_NULL) &&
+	    (osi_core->hw_feature->max_frp_entries != 0U) &&
+	    (osi_core->hw_feature->max_frp_entries < max)) {
+		max = osi_core->hw_feature->max_frp_entries;
+	}
+
+	if (frp_cnt >= OSI_FRP_MAX_ENTRY) {
+		ret = -1;
+		goto done;
+	}
+
+	/* Instructions targeted by links other than rule prefix skips */
+	for (s = 0U; s < frp_cnt; s = e) {
+		e = frp_rule_end(table, s, frp_cnt);
+		for (i = s; i < e; i++) {
+			oki = table[i].data.ok_index;
+			if ((table[i].data.next_ins_ctrl == OSI_ENABLE) &&
+			    (oki < frp_cnt) &&
+			    (frp_jump_out(&table[i].data, i, e) ==
+			     OSI_DISABLE)) {
+				link[oki / 32U] |= OSI_BIT(oki % 32U);
+			}
+		}
+	}
+
+	for (s = 0U; s < frp_cnt; s = e) {
+		e = frp_rule_end(table, s, frp_cnt);
+
+		/* Depth of prefix shared with the rule before */
+		d = 0U;
+		while ((d < depth) &&
+		       ((link[(s + d) / 32U] & OSI_BIT((s + d) % 32U)) == 0U) &&
+		       (frp_jump_out(&table[s + d].data, s + d, e) ==
+			OSI_ENABLE) &&
+		       (frp_match_equal(&prog[chain[d]], &table[s + d].data) ==
+			OSI_ENABLE)) {
+			d++;
+		}
+
+		for (k = 0U; k < d; k++) {
+			/* Shared instruction now skips this rule as well */
+			prog[chain[k]].ok_index = (nveu8_t)e;
+			map[s + k] = (nveu8_t)n;
+		}
+
+		depth = d;
+		for (i = s + d; i < e; i++) {
+			map[i] = (nveu8_t)n;
+			prog[n] = table[i].data;
+			if ((depth == (i - s)) && (depth < FRP_PREFIX_MAX) &&
+			    (frp_jump_out(&table[i].data, i, e) == OSI_ENABLE)) {
+				/* Prefix the next rule may share */
+				chain[depth] = n;
+				depth++;
+			}
+			n++;
+		}
+	}
+	map[frp_cnt] = (nveu8_t)n;
+
+	for (i = 0U; i < n; i++) {
+		if (prog[i].next_ins_ctrl == OSI_ENABLE) {
+			/* Link past the table continues at BYPASS rule */
+			oki = (prog[i].ok_index < frp_cnt) ?
+			      prog[i].ok_index : frp_cnt;
+			prog[i].ok_index = map[oki];
+		}
+	}
+
+	if ((n + 1U) > max) {
+		ret = -1;
+		goto done;
+	}
+
+	l_core->frp_prog_cnt = n;
+
+done:
+	if (ret < 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+			     "No space for rules\n", (nveul64_t)frp_cnt);
+	}
+
+	return ret;
+}
+
 /**
  * @brief frp_hw_write - Update HW FRP table.
  *
  * Algorithm: Update FRP table into HW.
+ * 1) Table is compiled into HW program, see frp_compile(). With a FRP
+ *    transaction open (HW re-init on resume) the table saved on
+ *    transaction start is used, it is the last one committed to HW.
+ *    Program followed by the XDCS BYPASS rule is compared against the
+ *    shadow copy of the last program written into HW.
+ * 2) Changed instructions beyond the active NVE are not parsed by HW,
+ *    so they are written with the parser running.
+ * 3) Parser is disabled only if an instruction inside the active range
+ *    changed, and only those instructions are re-written.
+ * 4) Full table is written if the shadow copy is not in sync with HW,
+ *    i.e. first update, after a MAC reset or a failed update.
  *
  * @param[in] osi_core: OSI core private data structure.
  * @param[in] ops_p: Core operations data structure.
@@ -382,74 +714,160 @@ done:
 nve32_t frp_hw_write(struct osi_core_priv_data *const osi_core,
 		     struct core_ops *const ops_p)
 {
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
 	nve32_t ret = 0;
 	nve32_t tmp = 0;
-	struct osi_core_frp_entry *entry;
 	struct osi_core_frp_data bypass_entry = {};
+	const struct osi_core_frp_entry *table = osi_core->frp_table;
+	struct osi_core_frp_data *data;
 	nveu32_t frp_cnt = osi_core->frp_cnt, i = OSI_NONE;
+	nveu32_t old_nve = l_core->frp_hw_nve;
+	nveu32_t active, dirty = OSI_DISABLE;
 
-	/* Disable the FRP in HW */
-	ret = ops_p->config_frp(osi_core, OSI_DISABLE);
+	if (l_core->frp_txn == OSI_ENABLE) {
+		/* Table is half built, keep HW on the committed one */
+		table = l_core->frp_txn_table;
+		frp_cnt = l_core->frp_txn_cnt;
+	}
+
+	/* Build HW program, checks space for XCS BYPASS rule */
+	ret = frp_compile(osi_core, table, frp_cnt);
 	if (ret < 0) {
-		/* Fail to disable try to enable it back */
-		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
-			"HW Fail on FRP update\n",
-			OSI_NONE);
-		goto hw_write_enable_frp;
+		goto error;
 	}
+	frp_cnt = l_core->frp_prog_cnt;
 
-	/* Check space for XCS BYPASS rule */
-	if ((frp_cnt + 1U) > OSI_FRP_MAX_ENTRY) {
-		ret = -1;
-		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
-			     "No space for rules\n", OSI_NONE);
+	if (frp_cnt == 0U) {
+		/* No rules, keep the parser disabled */
+		l_core->frp_hw_valid = OSI_DISABLE;
+		ret = ops_p->config_frp(osi_core, OSI_DISABLE);
+		if (ret < 0) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+				"HW Fail on FRP update\n",
+				OSI_NONE);
+		}
 		goto error;
 	}
 
-	/* Check HW table size for non-zero */
-	if (frp_cnt != 0U) {
-		/* Write FRP entries into HW  */
-		for (i = 0; i < frp_cnt; i++) {
-			entry = &osi_core->frp_table[i];
-			ret = ops_p->update_frp_entry(osi_core, i,
-						      &entry->data);
+	/* BYPASS rule for XDCS */
+	bypass_entry.match_en = 0x0U;
+	bypass_entry.accept_frame = 1;
+	bypass_entry.reject_frame = 1;
+
+	if (l_core->frp_hw_valid != OSI_ENABLE) {
+		/* Shadow is stale, force every instruction to be written */
+		osi_memset(l_core->frp_hw, 0xFFU, sizeof(l_core->frp_hw));
+		old_nve = 0U;
+		dirty = OSI_ENABLE;
+	} else {
+		/* Stage instructions HW is not parsing yet */
+		for (i = old_nve + 1U; i <= frp_cnt; i++) {
+			data = (i < frp_cnt) ? &l_core->frp_prog[i] :
+			       &bypass_entry;
+			ret = frp_hw_entry_write(osi_core, ops_p, i, data);
+			if (ret < 0) {
+				goto error;
+			}
+		}
+	}
+
+	active = (frp_cnt < old_nve) ? frp_cnt : old_nve;
+	for (i = 0U; (i <= active) && (dirty == OSI_DISABLE); i++) {
+		data = (i < frp_cnt) ? &l_core->frp_prog[i] :
+		       &bypass_entry;
+		if (frp_data_equal(&l_core->frp_hw[i], data) == OSI_DISABLE) {
+			dirty = OSI_ENABLE;
+		}
+	}
+
+	if (dirty == OSI_DISABLE) {
+		/* Active instructions unchanged, only move the NVE */
+		if (frp_cnt != old_nve) {
+			ret = ops_p->update_frp_nve(osi_core, frp_cnt);
 			if (ret < 0) {
 				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
-					"Fail to update FRP entry\n",
+					"Fail to update FRP NVE\n",
 					OSI_NONE);
-				goto hw_write_enable_frp;
+				goto error;
 			}
+			l_core->frp_hw_nve = frp_cnt;
 		}
+		goto error;
+	}
+
+	/* Disable the FRP in HW */
+	ret = ops_p->config_frp(osi_core, OSI_DISABLE);
+	if (ret < 0) {
+		/* Fail to disable try to enable it back */
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+			"HW Fail on FRP update\n",
+			OSI_NONE);
+		goto hw_write_enable_frp;
+	}
 
-		/* Write BYPASS rule for XDCS */
-		bypass_entry.match_en = 0x0U;
-		bypass_entry.accept_frame = 1;
-		bypass_entry.reject_frame = 1;
-		ret = ops_p->update_frp_entry(osi_core, frp_cnt, &bypass_entry);
+	/* Write changed FRP entries into HW */
+	active = (l_core->frp_hw_valid != OSI_ENABLE) ? frp_cnt : active;
+	for (i = 0U; i <= active; i++) {
+		data = (i < frp_cnt) ? &l_core->frp_prog[i] :
+		       &bypass_entry;
+		ret = frp_hw_entry_write(osi_core, ops_p, i, data);
 		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
-				"Fail to update BYPASS entry\n",
-				OSI_NONE);
 			goto hw_write_enable_frp;
 		}
+	}
 
-		/* Update the NVE */
-		ret = ops_p->update_frp_nve(osi_core, frp_cnt);
-		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
-				"Fail to update FRP NVE\n",
-				OSI_NONE);
-		}
+	/* Update the NVE */
+	ret = ops_p->update_frp_nve(osi_core, frp_cnt);
+	if (ret < 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+			"Fail to update FRP NVE\n",
+			OSI_NONE);
+		goto hw_write_enable_frp;
+	}
+	l_core->frp_hw_nve = frp_cnt;
+	l_core->frp_hw_valid = OSI_ENABLE;
 
-		/* Enable the FRP in HW */
+	/* Enable the FRP in HW */
 hw_write_enable_frp:
-		tmp = ops_p->config_frp(osi_core, OSI_ENABLE);
-	}
+	tmp = ops_p->config_frp(osi_core, OSI_ENABLE);
 
 error:
+	if ((ret < 0) || (tmp < 0)) {
+		/* HW state unknown, next update writes the full table */
+		l_core->frp_hw_valid = OSI_DISABLE;
+	}
+
 	return (ret < 0) ? ret : tmp;
 }
 
+/**
+ * @brief frp_hw_sync - Write FRP table into HW unless batched.
+ *
+ * Algorithm: Inside a FRP transaction HW is programmed once on commit,
+ *	otherwise write FRP table into HW right away.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] ops_p: Core operations data structure.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t frp_hw_sync(struct osi_core_priv_data *const osi_core,
+			   struct core_ops *const ops_p)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nve32_t ret = 0;
+
+	if (l_core->frp_txn == OSI_ENABLE) {
+		/* Programmed on transaction commit */
+		goto done;
+	}
+
+	ret = frp_hw_write(osi_core, ops_p);
+done:
+	return ret;
+}
+
 /**
  * @brief frp_add_proto - Process and update FRP Command Protocal Entry.
  *
@@ -615,7 +1033,8 @@ static nve32_t frp_delete(struct osi_core_priv_data *const osi_core,
 			  struct osi_core_frp_cmd *const cmd)
 {
 	nve32_t ret;
-	nveu8_t i = 0U, pos = 0U, count = 0U;
+	struct osi_core_frp_data *data;
+	nveu8_t i = 0U, pos = 0U, count = 0U, start;
 	nve32_t frp_id = cmd->frp_id;
 	nveu32_t frp_cnt = osi_core->frp_cnt;
 
@@ -646,6 +1065,8 @@ static nve32_t frp_delete(struct osi_core_priv_data *const osi_core,
 		goto done;
 	}
 
+	start = pos;
+
 	/* Update the frp_table entry */
 	osi_memset(&osi_core->frp_table[pos], 0U,
 		   (sizeof(struct osi_core_frp_entry) * count));
@@ -660,8 +1081,26 @@ static nve32_t frp_delete(struct osi_core_priv_data *const osi_core,
 	/* Update the frp_cnt entry */
 	osi_core->frp_cnt = (frp_cnt - count);
 
+	/* Entries after the deleted ones moved, re-index */
+	frp_idx_rebuild(osi_core);
+
+	/* Fix OKI of links pointing into or past the deleted entries,
+	 * a link into them continues with the entry that follows them */
+	for (i = 0U; i < osi_core->frp_cnt; i++) {
+		data = &osi_core->frp_table[i].data;
+		if ((data->next_ins_ctrl == OSI_ENABLE) &&
+		    (data->ok_index >= (nveu8_t)(start + count))) {
+			data->ok_index = (nveu8_t)(data->ok_index - count);
+		} else if ((data->next_ins_ctrl == OSI_ENABLE) &&
+			   (data->ok_index > start)) {
+			data->ok_index = start;
+		} else {
+			/* Link before the deleted entries */
+		}
+	}
+
 	/* Write FRP Table into HW */
-	ret = frp_hw_write(osi_core, ops_p);
+	ret = frp_hw_sync(osi_core, ops_p);
 	if (ret < 0) {
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			"Fail to update FRP NVE\n",
@@ -750,7 +1189,7 @@ static nve32_t frp_update(struct osi_core_priv_data *const osi_core,
 	}
 
 	/* Write FRP Table into HW */
-	ret = frp_hw_write(osi_core, ops_p);
+	ret = frp_hw_sync(osi_core, ops_p);
 	if (ret < 0) {
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			"Fail to update FRP NVE\n",
@@ -780,7 +1219,7 @@ static nve32_t frp_add(struct osi_core_priv_data *const osi_core,
 	nve32_t ret;
 	nveu8_t pos = 0U, count = 0U;
 	nve32_t frp_id = cmd->frp_id;
-	nveu32_t nve = osi_core->frp_cnt;
+	nveu32_t nve = osi_core->frp_cnt, start;
 
 	/* Check for MAX FRP entries */
 	if (nve >= OSI_FRP_MAX_ENTRY) {
@@ -803,6 +1242,7 @@ static nve32_t frp_add(struct osi_core_priv_data *const osi_core,
 
 	/* Parse match type and update command offset */
 	frp_parse_mtype(cmd);
+	start = nve;
 
 	/* Process and add FRP Command Protocal Entry */
 	ret = frp_add_proto(osi_core, cmd, (nveu8_t *)&nve);
@@ -826,9 +1266,11 @@ static nve32_t frp_add(struct osi_core_priv_data *const osi_core,
 	}
 	osi_core->frp_cnt = nve + frp_req_entries(cmd->offset,
 						  cmd->match_length);
+	frp_idx_insert(osi_core, frp_id, (nveu8_t)start,
+		       (nveu8_t)(osi_core->frp_cnt - start));
 
 	/* Write FRP Table into HW */
-	ret = frp_hw_write(osi_core, ops_p);
+	ret = frp_hw_sync(osi_core, ops_p);
 	if (ret < 0) {
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			"Fail to update FRP NVE\n",
@@ -839,6 +1281,135 @@ done:
 	return ret;
 }
 
+/**
+ * @brief frp_txn_begin - Start FRP transaction.
+ *
+ * Algorithm: Save FRP table for rollback, following add, update and
+ *	delete commands only update the FRP table.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t frp_txn_begin(struct osi_core_priv_data *const osi_core)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nve32_t ret = -1;
+
+	if (l_core->frp_txn == OSI_ENABLE) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "FRP transaction already started\n", OSI_NONE);
+		goto done;
+	}
+
+	(void)osi_memcpy(l_core->frp_txn_table, osi_core->frp_table,
+			 sizeof(struct osi_core_frp_entry) * osi_core->frp_cnt);
+	l_core->frp_txn_cnt = osi_core->frp_cnt;
+#ifndef OSI_STRIPPED_LIB
+	(void)osi_memcpy(l_core->frp_txn_flows, l_core->flows,
+			 sizeof(l_core->flows));
+#endif /* !OSI_STRIPPED_LIB */
+	l_core->frp_txn_err = OSI_DISABLE;
+	l_core->frp_txn = OSI_ENABLE;
+	ret = 0;
+done:
+	return ret;
+}
+
+/**
+ * @brief frp_txn_rollback - Restore FRP table saved on transaction start.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ */
+static void frp_txn_rollback(struct osi_core_priv_data *const osi_core)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+
+	(void)osi_memcpy(osi_core->frp_table, l_core->frp_txn_table,
+			 sizeof(struct osi_core_frp_entry) * l_core->frp_txn_cnt);
+	osi_core->frp_cnt = l_core->frp_txn_cnt;
+#ifndef OSI_STRIPPED_LIB
+	(void)osi_memcpy(l_core->flows, l_core->frp_txn_flows,
+			 sizeof(l_core->flows));
+#endif /* !OSI_STRIPPED_LIB */
+	frp_idx_rebuild(osi_core);
+}
+
+/**
+ * @brief frp_txn_end - Commit or abort FRP transaction.
+ *
+ * Algorithm:
+ * 1) On abort, or commit of a transaction with a failed command, restore
+ *    the FRP table saved on transaction start.
+ * 2) On commit, write the FRP table into HW once. If that fails restore
+ *    the saved FRP table and write it back into HW.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] ops_p: Core operations data structure.
+ * @param[in] commit: OSI_ENABLE to commit, OSI_DISABLE to abort.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t frp_txn_end(struct osi_core_priv_data *const osi_core,
+			   struct core_ops *const ops_p,
+			   nveu32_t commit)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nve32_t ret = -1;
+
+	if (l_core->frp_txn != OSI_ENABLE) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "No FRP transaction started\n", OSI_NONE);
+		goto done;
+	}
+
+	l_core->frp_txn = OSI_DISABLE;
+
+	if ((commit != OSI_ENABLE) || (l_core->frp_txn_err == OSI_ENABLE)) {
+		frp_txn_rollback(osi_core);
+		ret = (commit != OSI_ENABLE) ? 0 : -1;
+		goto done;
+	}
+
+	ret = frp_hw_write(osi_core, ops_p);
+	if (ret < 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+			     "FRP transaction commit failed\n", OSI_NONE);
+		frp_txn_rollback(osi_core);
+		(void)frp_hw_write(osi_core, ops_p);
+	}
+
+done:
+	return ret;
+}
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief frp_flow_slot - Find stored flow steering rule by flow ID
+ *
+ * @param[in] l_core: Core local private data structure.
+ * @param[in] flow_id: Flow ID.
+ *
+ * @retval Flow slot index, OSI_MAX_FLOWS if not found.
+ */
+static nveu32_t frp_flow_slot(struct core_local *const l_core,
+			      nve32_t flow_id)
+{
+	nveu32_t i;
+
+	for (i = 0U; i < OSI_MAX_FLOWS; i++) {
+		if ((l_core->flows[i].used == OSI_ENABLE) &&
+		    (l_core->flows[i].spec.flow_id == flow_id)) {
+			break;
+		}
+	}
+
+	return i;
+}
+#endif /* !OSI_STRIPPED_LIB */
+
 /**
  * @brief setup_frp - Process OSD FRP Command.
  *
@@ -855,6 +1426,10 @@ nve32_t setup_frp(struct osi_core_priv_data *const osi_core,
 		  struct core_ops *ops_p,
 		  struct osi_core_frp_cmd *const cmd)
 {
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+#ifndef OSI_STRIPPED_LIB
+	nveu32_t slot;
+#endif /* !OSI_STRIPPED_LIB */
 	nve32_t ret = -1;
 
 	switch (cmd->cmd) {
@@ -866,6 +1441,24 @@ nve32_t setup_frp(struct osi_core_priv_data *const osi_core,
 		break;
 	case OSI_FRP_CMD_DEL:
 		ret = frp_delete(osi_core, ops_p, cmd);
+#ifndef OSI_STRIPPED_LIB
+		if (ret == 0) {
+			/* FRP ID may be a flow steering rule */
+			slot = frp_flow_slot(l_core, cmd->frp_id);
+			if (slot < OSI_MAX_FLOWS) {
+				l_core->flows[slot].used = OSI_DISABLE;
+			}
+		}
+#endif /* !OSI_STRIPPED_LIB */
+		break;
+	case OSI_FRP_CMD_BEGIN:
+		ret = frp_txn_begin(osi_core);
+		break;
+	case OSI_FRP_CMD_COMMIT:
+		ret = frp_txn_end(osi_core, ops_p, OSI_ENABLE);
+		break;
+	case OSI_FRP_CMD_ABORT:
+		ret = frp_txn_end(osi_core, ops_p, OSI_DISABLE);
 		break;
 	default:
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
@@ -882,7 +1475,454 @@ nve32_t setup_frp(struct osi_core_priv_data *const osi_core,
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			     "FRP command fail\n",
 			      cmd->cmd);
+		if ((l_core->frp_txn == OSI_ENABLE) &&
+		    (cmd->cmd != OSI_FRP_CMD_BEGIN)) {
+			/* Commit will roll back the whole transaction, a
+			 * nested BEGIN is rejected and leaves it alone */
+			l_core->frp_txn_err = OSI_ENABLE;
+		}
+	}
+
+	return ret;
+}
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief frp_eval - Run a frame through the FRP program in SW.
+ *
+ * Algorithm: Compile FRP table the same way frp_hw_write() does and
+ *	execute the program followed by the XDCS BYPASS rule, from index 0,
+ *	the same way the HW parser does. An empty table leaves the parser
+ *	disabled and the frame takes default routing.
+ *	1) Match data word is taken from frame at FO * 4, enabled bytes beyond
+ *	   the frame length never match. IM inverts the comparison result.
+ *	2) On match with NIC set, continue from OKI, OKI which is not ahead of
+ *	   the current instruction ends parsing with BYPASS.
+ *	3) On match without NIC, AF/RF decide route, drop or bypass; an
+ *	   instruction without AF and RF falls through to next instruction.
+ *	4) On mismatch, continue with next instruction.
+ *	No HW register is accessed.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in, out] eval: Frame to evaluate and evaluation result.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+nve32_t frp_eval(struct osi_core_priv_data *const osi_core,
+		 struct osi_frp_eval *const eval)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct osi_core_frp_data bypass_entry = {};
+	const struct osi_core_frp_data *data;
+	nveu32_t pc = 0U, off, j, word, match;
+	nve32_t ret = -1;
+
+	if ((eval == OSI_NULL) ||
+	    ((eval->frame == OSI_NULL) && (eval->len != 0U))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid FRP evaluation frame\n", 0ULL);
+		goto done;
+	}
+
+	eval->action = OSI_FRP_MODE_BYPASS;
+	eval->dma_sel = 0U;
+	eval->index = 0U;
+	eval->insn_cnt = 0U;
+
+	ret = frp_compile(osi_core, osi_core->frp_table, osi_core->frp_cnt);
+	if ((ret < 0) || (l_core->frp_prog_cnt == 0U)) {
+		/* No program, frame takes default routing */
+		goto done;
+	}
+
+	/* BYPASS rule for XDCS */
+	bypass_entry.accept_frame = OSI_ENABLE;
+	bypass_entry.reject_frame = OSI_ENABLE;
+
+	while (pc <= l_core->frp_prog_cnt) {
+		data = (pc < l_core->frp_prog_cnt) ? &l_core->frp_prog[pc] :
+		       &bypass_entry;
+		eval->insn_cnt++;
+		eval->index = pc;
+
+		/* Build match data word from frame */
+		off = (nveu32_t)data->frame_offset * FRP_MD_SIZE;
+		word = 0U;
+		match = OSI_ENABLE;
+		for (j = 0U; j < FRP_MD_SIZE; j++) {
+			if (((data->match_en >> (j * FRP_ME_BYTE_SHIFT)) &
+			     FRP_ME_BYTE) == 0U) {
+				continue;
+			}
+			if ((off + j) >= eval->len) {
+				match = OSI_DISABLE;
+				break;
+			}
+			word |= ((nveu32_t)eval->frame[off + j] <<
+				 (j * FRP_ME_BYTE_SHIFT));
+		}
+
+		if ((match == OSI_ENABLE) &&
+		    (((word ^ data->match_data) & data->match_en) != 0U)) {
+			match = OSI_DISABLE;
+		}
+
+		if (data->inverse_match == OSI_ENABLE) {
+			match = (match == OSI_ENABLE) ? OSI_DISABLE : OSI_ENABLE;
+		}
+
+		if (match == OSI_DISABLE) {
+			pc++;
+			continue;
+		}
+
+		if (data->next_ins_ctrl == OSI_ENABLE) {
+			if (data->ok_index <= pc) {
+				/* Invalid link, HW can only jump forward */
+				break;
+			}
+			pc = data->ok_index;
+			continue;
+		}
+
+		if ((data->accept_frame == OSI_ENABLE) &&
+		    (data->reject_frame == OSI_ENABLE)) {
+			eval->action = OSI_FRP_MODE_BYPASS;
+		} else if (data->accept_frame == OSI_ENABLE) {
+			eval->action = OSI_FRP_MODE_ROUTE;
+			eval->dma_sel = data->dma_chsel;
+		} else if (data->reject_frame == OSI_ENABLE) {
+			eval->action = OSI_FRP_MODE_DROP;
+		} else {
+			pc++;
+			continue;
+		}
+		break;
+	}
+
+done:
+	return ret;
+}
+#endif /* !OSI_STRIPPED_LIB */
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief frp_flow_set - Add a frame byte match into flow match words
+ *
+ * @param[in, out] md: Match data words.
+ * @param[in, out] me: Match enable words.
+ * @param[in] off: Frame byte offset.
+ * @param[in] val: Byte value to match.
+ * @param[in] mask: Bits of the byte to match.
+ */
+static void frp_flow_set(nveu32_t *md, nveu32_t *me, nveu32_t off,
+			 nveu32_t val, nveu32_t mask)
+{
+	nveu32_t word = off / FRP_MD_SIZE;
+	nveu32_t shift = (off % FRP_MD_SIZE) * FRP_ME_BYTE_SHIFT;
+
+	md[word] |= ((val & mask & FRP_ME_BYTE) << shift);
+	me[word] |= ((mask & FRP_ME_BYTE) << shift);
+}
+
+/**
+ * @brief frp_flow_set16 - Add a network order 16-bit match into flow words
+ *
+ * @param[in, out] md: Match data words.
+ * @param[in, out] me: Match enable words.
+ * @param[in] off: Frame byte offset.
+ * @param[in] val: Value to match.
+ * @param[in] mask: Bits of the value to match.
+ */
+static void frp_flow_set16(nveu32_t *md, nveu32_t *me, nveu32_t off,
+			   nveu32_t val, nveu32_t mask)
+{
+	frp_flow_set(md, me, off, val >> FRP_ME_BYTE_SHIFT,
+		     mask >> FRP_ME_BYTE_SHIFT);
+	frp_flow_set(md, me, off + 1U, val, mask);
+}
+
+/**
+ * @brief frp_flow_validate - Validate flow steering rule for add
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] spec: Flow steering rule.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t frp_flow_validate(struct osi_core_priv_data *const osi_core,
+				 const struct osi_flow_spec *const spec)
+{
+	const nveu32_t max_chans[MAX_MAC_IP_TYPES] = {OSI_EQOS_MAX_NUM_CHANS,
+						      OSI_MGBE_MAX_NUM_CHANS};
+	const nveu32_t l4 = OSI_FLOW_L4_SRC | OSI_FLOW_L4_DST;
+	const nveu32_t ip4 = OSI_FLOW_IP4_SRC | OSI_FLOW_IP4_DST |
+			     OSI_FLOW_IP4_PROTO | l4;
+	nve32_t ret = -1;
+
+	if ((spec->fields == 0U) ||
+	    ((spec->fields & ~OSI_FLOW_FIELDS_MASK) != 0U)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid flow fields\n", (nveul64_t)spec->fields);
+		goto done;
+	}
+
+	if (spec->dma_chan >= max_chans[osi_core->mac]) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid flow DMA channel\n",
+			     (nveul64_t)spec->dma_chan);
+		goto done;
+	}
+
+	if (((spec->fields & OSI_FLOW_VLAN) != 0U) &&
+	    (spec->vlan_id > FRP_VLAN_VID_MASK)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid flow VLAN ID\n",
+			     (nveul64_t)spec->vlan_id);
+		goto done;
+	}
+
+	if (((spec->fields & OSI_FLOW_ETHTYPE) != 0U) &&
+	    ((spec->fields & ip4) != 0U)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Flow EtherType conflicts with IPv4 fields\n",
+			     (nveul64_t)spec->ethertype);
+		goto done;
+	}
+
+	if (((spec->fields & l4) != 0U) &&
+	    (((spec->fields & OSI_FLOW_IP4_PROTO) == 0U) ||
+	     ((spec->ip4_proto != FRP_L4_TCP_MD) &&
+	      (spec->ip4_proto != FRP_L4_UDP_MD)))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Flow L4 ports need TCP or UDP protocol\n",
+			     (nveul64_t)spec->ip4_proto);
+		goto done;
+	}
+
+	ret = 0;
+done:
+	return ret;
+}
+
+/**
+ * @brief frp_flow_add - Add flow steering rule
+ *
+ * Algorithm:
+ * 1) Validate rule, flow ID must not be used by another FRP ID.
+ * 2) Collect match data and enable bits of all fields per 4 byte frame
+ *    word, IPv4 fields imply IPv4 EtherType and VLAN shifts L3 by 4 bytes.
+ * 3) Append one FRP instruction per word with match bits. All but the
+ *    last are inverse match with NIC set and OKI just past the flow, so a
+ *    word which does not match jumps over the rest of the flow while a
+ *    matching word falls through to the next one. Last word routes to
+ *    target DMA channel, it is only reached when all words matched.
+ * 4) Write FRP table into HW, unless a FRP transaction is open.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] ops_p: Core operations data structure.
+ * @param[in] spec: Flow steering rule.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static nve32_t frp_flow_add(struct osi_core_priv_data *const osi_core,
+			    struct core_ops *const ops_p,
+			    const struct osi_flow_spec *const spec)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	const nveu32_t ip4 = OSI_FLOW_IP4_SRC | OSI_FLOW_IP4_DST |
+			     OSI_FLOW_IP4_PROTO | OSI_FLOW_L4_SRC |
+			     OSI_FLOW_L4_DST;
+	nveu32_t md[FRP_FLOW_WORDS] = {0U};
+	nveu32_t me[FRP_FLOW_WORDS] = {0U};
+	struct osi_core_frp_entry *entry = OSI_NULL;
+	nveu32_t etype_off = FRP_ETH_TYPE_OFFSET;
+	nveu32_t l3 = FRP_L2_HDR_LEN, l4;
+	nveu32_t i, j, n = 0U, pos, slot = OSI_MAX_FLOWS;
+	nveu8_t start = 0U, count = 0U;
+	nve32_t ret = -1;
+
+	if (frp_flow_validate(osi_core, spec) < 0) {
+		goto done;
+	}
+
+	if (frp_entry_find(osi_core, spec->flow_id, &start, &count) == 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Flow ID already in use\n",
+			     (nveul64_t)spec->flow_id);
+		goto done;
+	}
+
+	for (i = 0U; i < OSI_MAX_FLOWS; i++) {
+		if (l_core->flows[i].used == OSI_DISABLE) {
+			slot = i;
+			break;
+		}
+	}
+	if (slot == OSI_MAX_FLOWS) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_OUTOFBOUND,
+			     "Flow table full\n", OSI_NONE);
+		goto done;
+	}
+
+	if ((spec->fields & OSI_FLOW_VLAN) != 0U) {
+		frp_flow_set16(md, me, FRP_ETH_TYPE_OFFSET,
+			       FRP_ETH_TYPE_VLAN, 0xFFFFU);
+		frp_flow_set16(md, me, FRP_VLAN_TCI_OFFSET,
+			       spec->vlan_id, FRP_VLAN_VID_MASK);
+		etype_off += FRP_VLAN_HDR_LEN;
+		l3 += FRP_VLAN_HDR_LEN;
 	}
 
+	if ((spec->fields & ip4) != 0U) {
+		frp_flow_set16(md, me, etype_off, FRP_ETH_TYPE_IP4, 0xFFFFU);
+	} else if ((spec->fields & OSI_FLOW_ETHTYPE) != 0U) {
+		frp_flow_set16(md, me, etype_off, spec->ethertype, 0xFFFFU);
+	} else {
+		/* VLAN only flow */
+	}
+
+	if ((spec->fields & OSI_FLOW_IP4_PROTO) != 0U) {
+		frp_flow_set(md, me, l3 + FRP_IP4_PROTO_OFFSET,
+			     spec->ip4_proto, FRP_ME_BYTE);
+	}
+
+	for (j = 0U; j < 4U; j++) {
+		if ((spec->fields & OSI_FLOW_IP4_SRC) != 0U) {
+			frp_flow_set(md, me, l3 + FRP_IP4_SRC_OFFSET + j,
+				     spec->ip4_src[j], FRP_ME_BYTE);
+		}
+		if ((spec->fields & OSI_FLOW_IP4_DST) != 0U) {
+			frp_flow_set(md, me, l3 + FRP_IP4_DST_OFFSET + j,
+				     spec->ip4_dst[j], FRP_ME_BYTE);
+		}
+	}
+
+	l4 = l3 + FRP_IP4_HDR_LEN;
+	if ((spec->fields & OSI_FLOW_L4_SRC) != 0U) {
+		frp_flow_set16(md, me, l4, spec->l4_src, 0xFFFFU);
+	}
+	if ((spec->fields & OSI_FLOW_L4_DST) != 0U) {
+		frp_flow_set16(md, me, l4 + FRP_L4_DST_OFFSET,
+			       spec->l4_dst, 0xFFFFU);
+	}
+
+	for (i = 0U; i < FRP_FLOW_WORDS; i++) {
+		if (me[i] != 0U) {
+			n++;
+		}
+	}
+
+	/* Check space, one entry is reserved for XDCS BYPASS rule */
+	if ((osi_core->frp_cnt + n) >= OSI_FRP_MAX_ENTRY) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_OUTOFBOUND,
+			     "No space to add flow\n", (nveul64_t)n);
+		goto done;
+	}
+
+	pos = osi_core->frp_cnt;
+	for (i = 0U; i < FRP_FLOW_WORDS; i++) {
+		if (me[i] == 0U) {
+			continue;
+		}
+
+		entry = &osi_core->frp_table[pos];
+		osi_memset(entry, 0U, sizeof(struct osi_core_frp_entry));
+		entry->frp_id = spec->flow_id;
+		entry->data.match_data = md[i];
+		entry->data.match_en = me[i];
+		entry->data.frame_offset = (nveu8_t)i;
+		/* Word mismatch skips the rest of this flow */
+		entry->data.inverse_match = OSI_ENABLE;
+		entry->data.next_ins_ctrl = OSI_ENABLE;
+		entry->data.ok_index = (nveu8_t)(osi_core->frp_cnt + n);
+		pos++;
+	}
+
+	/* Last instruction routes the frame */
+	entry->data.inverse_match = OSI_DISABLE;
+	entry->data.next_ins_ctrl = OSI_DISABLE;
+	entry->data.ok_index = OSI_DISABLE;
+	entry->data.dma_chsel = OSI_BIT(spec->dma_chan);
+	frp_entry_mode_parse(OSI_FRP_MODE_ROUTE, &entry->data);
+
+	start = (nveu8_t)osi_core->frp_cnt;
+	osi_core->frp_cnt = pos;
+	frp_idx_insert(osi_core, spec->flow_id, start, (nveu8_t)n);
+
+	ret = frp_hw_sync(osi_core, ops_p);
+	if (ret < 0) {
+		/* Drop the flow from FRP table */
+		osi_core->frp_cnt = start;
+		frp_idx_rebuild(osi_core);
+		goto done;
+	}
+
+	l_core->flows[slot].spec = *spec;
+	l_core->flows[slot].used = OSI_ENABLE;
+done:
+	return ret;
+}
+
+/**
+ * @brief setup_flow - Process flow steering command.
+ *
+ * Algorithm: Add, delete or get a flow steering rule. A flow is stored
+ *	as one FRP ID whose instructions AND all requested fields and route
+ *	matching frames to the target DMA channel.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] ops_p: Core operations data structure.
+ * @param[in, out] spec: Flow steering rule, filled on OSI_FLOW_CMD_GET.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+nve32_t setup_flow(struct osi_core_priv_data *const osi_core,
+		   struct core_ops *const ops_p,
+		   struct osi_flow_spec *const spec)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	struct osi_core_frp_cmd cmd = {0};
+	nveu32_t slot;
+	nve32_t ret = -1;
+
+	if (spec->cmd == OSI_FLOW_CMD_ADD) {
+		ret = frp_flow_add(osi_core, ops_p, spec);
+		goto done;
+	}
+
+	slot = frp_flow_slot(l_core, spec->flow_id);
+	if (slot == OSI_MAX_FLOWS) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Flow not found\n", (nveul64_t)spec->flow_id);
+		goto done;
+	}
+
+	switch (spec->cmd) {
+	case OSI_FLOW_CMD_DEL:
+		cmd.cmd = OSI_FRP_CMD_DEL;
+		cmd.frp_id = spec->flow_id;
+		ret = frp_delete(osi_core, ops_p, &cmd);
+		if (ret == 0) {
+			l_core->flows[slot].used = OSI_DISABLE;
+		}
+		break;
+	case OSI_FLOW_CMD_GET:
+		*spec = l_core->flows[slot].spec;
+		spec->cmd = OSI_FLOW_CMD_GET;
+		ret = 0;
+		break;
+	default:
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid flow command\n", (nveul64_t)spec->cmd);
+		break;
+	}
+
+done:
 	return ret;
 }
+#endif /* !OSI_STRIPPED_LIB */
@@ -49,6 +49,26 @@
 #define FRP_L4_UDP_MD			17U
 #define FRP_L4_TCP_MD			6U
 
+/* Max depth of rule prefix shared by FRP compiler */
+#define FRP_PREFIX_MAX			16U
+
+#ifndef OSI_STRIPPED_LIB
+/* Flow steering frame layout */
+#define FRP_FLOW_WORDS			16U
+#define FRP_ETH_TYPE_OFFSET		12U
+#define FRP_ETH_TYPE_IP4		0x0800U
+#define FRP_ETH_TYPE_VLAN		0x8100U
+#define FRP_VLAN_VID_MASK		0x0FFFU
+#define FRP_VLAN_TCI_OFFSET		14U
+#define FRP_VLAN_HDR_LEN		4U
+#define FRP_L2_HDR_LEN			14U
+#define FRP_IP4_PROTO_OFFSET		9U
+#define FRP_IP4_SRC_OFFSET		12U
+#define FRP_IP4_DST_OFFSET		16U
+#define FRP_IP4_HDR_LEN			20U
+#define FRP_L4_DST_OFFSET		2U
+#endif /* !OSI_STRIPPED_LIB */
+
 /* Define for FRP Entries offsets and lengths */
 #define FRP_OFFSET_BYTES(offset) \
 	(FRP_MD_SIZE - ((offset) % FRP_MD_SIZE))
@@ -80,4 +100,40 @@ nve32_t setup_frp(struct osi_core_priv_data *const osi_core,
  */
 nve32_t frp_hw_write(struct osi_core_priv_data *const osi_core,
 		     struct core_ops *const ops_p);
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief frp_eval - Run a frame through the FRP program in SW.
+ *
+ * Algorithm: Compile FRP table and execute the program followed by the
+ *	BYPASS rule over the given frame, report the action, DMA selection
+ *	and instruction count. Works without HW.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in, out] eval: Frame to evaluate and evaluation result.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+nve32_t frp_eval(struct osi_core_priv_data *const osi_core,
+		 struct osi_frp_eval *const eval);
+
+/**
+ * @brief setup_flow - Process flow steering command.
+ *
+ * Algorithm: Add, delete or get a flow steering rule. A flow is stored
+ *	as one FRP ID whose instructions AND all requested fields and route
+ *	matching frames to the target DMA channel.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] ops_p: Core operations data structure.
+ * @param[in, out] spec: Flow steering rule, filled on OSI_FLOW_CMD_GET.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+nve32_t setup_flow(struct osi_core_priv_data *const osi_core,
+		   struct core_ops *const ops_p,
+		   struct osi_flow_spec *const spec);
+#endif /* !OSI_STRIPPED_LIB */
 #endif /* FRP_H */
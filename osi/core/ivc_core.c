@@ -30,6 +30,37 @@
 #include "../osi/common/common.h"
 #include "macsec.h"
 
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief ivc_cmd_supported - Check if a runtime command can go over IVC
+ *
+ * Algorithm: osi_ioctl is copied by value into the IVC message, commands
+ *	whose data points into caller memory can not be marshalled.
+ *
+ * @param[in] cmd: OSI IOCTL command.
+ *
+ * @retval OSI_ENABLE if command can be sent over IVC.
+ * @retval OSI_DISABLE otherwise.
+ */
+static nveu32_t ivc_cmd_supported(nveu32_t cmd)
+{
+	nveu32_t ret = OSI_ENABLE;
+
+	switch (cmd) {
+	case OSI_CMD_FRP_EVAL:
+	case OSI_CMD_L2_ADDR_LIST:
+	case OSI_CMD_VLAN_LIST:
+		ret = OSI_DISABLE;
+		break;
+	default:
+		/* Data is fully contained in osi_ioctl */
+		break;
+	}
+
+	return ret;
+}
+#endif /* !OSI_STRIPPED_LIB */
+
 /**
  * @brief ivc_handle_ioctl - marshell input argument to handle runtime command
  *
@@ -47,6 +78,16 @@ static nve32_t ivc_handle_ioctl(struct osi_core_priv_data *osi_core,
 	nve32_t ret = 0;
 	ivc_msg_common_t msg;
 
+#ifndef OSI_STRIPPED_LIB
+	if (ivc_cmd_supported(data->cmd) == OSI_DISABLE) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Command not supported over IVC\n",
+			     (nveul64_t)data->cmd);
+		ret = -1;
+		goto done;
+	}
+#endif /* !OSI_STRIPPED_LIB */
+
 	osi_memset(&msg, 0, sizeof(msg));
 
 	msg.cmd = handle_ioctl;
@@ -84,6 +125,9 @@ static nve32_t ivc_handle_ioctl(struct osi_core_priv_data *osi_core,
 		break;
 	}
 
+#ifndef OSI_STRIPPED_LIB
+done:
+#endif /* !OSI_STRIPPED_LIB */
 	return ret;
 }
 
@@ -32,41 +32,130 @@
 #include "macsec.h"
 
 /**
- * @brief mgbe_poll_for_mac_accrtl - Poll for Indirect Access control and status
- * register operations complete.
+ * @brief MGBE indirect access ports, indexed by MGBE_INDIR_*
+ */
+static const struct mgbe_indir_port {
+	/** Data register offset */
+	nveu32_t data_reg;
+	/** Control register offset */
+	nveu32_t ctrl_reg;
+	/** Busy bit in control register */
+	nveu32_t busy;
+	/** Delay in usec between busy polls */
+	nveu32_t wait;
+	/** Number of busy polls */
+	nveu32_t retry;
+} mgbe_indir_ports[MGBE_INDIR_MAX] = {
+	{ MGBE_MAC_INDIR_DATA, MGBE_MAC_INDIR_AC, MGBE_MAC_INDIR_AC_OB,
+	  MGBE_MAC_INDIR_AC_OB_WAIT, MGBE_MAC_INDIR_AC_OB_RETRY },
+	{ MGBE_MAC_L3L4_DATA, MGBE_MAC_L3L4_ADDR_CTR, MGBE_MAC_L3L4_ADDR_CTR_XB,
+	  MGBE_MAC_XB_WAIT, MGBE_MAC_XB_RETRY },
+	{ MGBE_MTL_RXP_IND_DATA, MGBE_MTL_RXP_IND_CS, MGBE_MTL_RXP_IND_CS_BUSY,
+	  MGBE_MTL_FRP_READ_UDELAY, MGBE_MTL_FRP_READ_RETRY },
+#ifndef OSI_STRIPPED_LIB
+	{ MGBE_MAC_RSS_DATA, MGBE_MAC_RSS_ADDR, MGBE_MAC_RSS_ADDR_OB,
+	  MGBE_MAC_RSS_OB_WAIT, MGBE_MAC_RSS_OB_RETRY },
+#endif /* !OSI_STRIPPED_LIB */
+};
+
+/**
+ * @brief mgbe_indir_wait - Wait for indirect access port to be idle
  *
- * Algorithm: Waits for waits for transfer busy bit to be cleared in
- * MAC Indirect address control register to complete operations.
+ * Algorithm: If an operation was issued on the port and not waited for
+ * yet, poll its busy bit until clear. Back to back writes to a port
+ * overlap HW completion of one with setup of the next, and a batch is
+ * completed by a single wait at the end.
  *
  * @param[in] osi_core: osi core priv data structure
+ * @param[in] port: MGBE_INDIR_* port
  *
  * @note MAC needs to be out of reset and proper clock configured.
  *
  * @retval 0 on success
  * @retval -1 on failure.
  */
-static nve32_t mgbe_poll_for_mac_acrtl(struct osi_core_priv_data *osi_core)
+static nve32_t mgbe_indir_wait(struct osi_core_priv_data *osi_core,
+			       nveu32_t port)
 {
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	const struct mgbe_indir_port *p = &mgbe_indir_ports[port];
 	nveu32_t count = 0U;
-	nveu32_t mac_indir_addr_ctrl = 0U;
+	nveu32_t val = 0U;
 	nve32_t ret = -1;
 
-	/* Poll Until MAC_Indir_Access_Ctrl OB is clear */
-	while (count < MGBE_MAC_INDIR_AC_OB_RETRY) {
-		mac_indir_addr_ctrl = osi_readla(osi_core,
-						 (nveu8_t *)osi_core->base +
-						 MGBE_MAC_INDIR_AC);
-		if ((mac_indir_addr_ctrl & MGBE_MAC_INDIR_AC_OB) == OSI_NONE) {
-			/* OB is clear exit the loop */
+	if ((l_core->indir_pending & OSI_BIT(port)) == OSI_NONE) {
+		ret = 0;
+		goto done;
+	}
+
+	/* Poll until busy bit is clear */
+	while (count <= p->retry) {
+		val = osi_readla(osi_core, (nveu8_t *)osi_core->base +
+				 p->ctrl_reg);
+		if ((val & p->busy) == OSI_NONE) {
 			ret = 0;
 			break;
 		}
 
-		/* wait for 10 usec for OB clear and retry */
-		osi_core->osd_ops.udelay(MGBE_MAC_INDIR_AC_OB_WAIT);
+		osi_core->osd_ops.udelay(p->wait);
 		count++;
 	}
 
+	l_core->indir_pending &= ~OSI_BIT(port);
+	if (ret < 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+			     "Indirect access timed out\n", port);
+	}
+
+done:
+	return ret;
+}
+
+/**
+ * @brief mgbe_indir_issue - Issue indirect access port operation
+ *
+ * Algorithm: Wait for previous operation on the port, write data,
+ * update control register fields and set busy bit. Completion is not
+ * waited for, use mgbe_indir_wait().
+ *
+ * @param[in] osi_core: osi core priv data structure
+ * @param[in] port: MGBE_INDIR_* port
+ * @param[in] data: Data register value
+ * @param[in] ctrl_mask: Control register bits to replace
+ * @param[in] ctrl: Control register value of ctrl_mask bits
+ *
+ * @note MAC needs to be out of reset and proper clock configured.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t mgbe_indir_issue(struct osi_core_priv_data *osi_core,
+				nveu32_t port, nveu32_t data,
+				nveu32_t ctrl_mask, nveu32_t ctrl)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	const struct mgbe_indir_port *p = &mgbe_indir_ports[port];
+	nveu8_t *base = (nveu8_t *)osi_core->base;
+	nveu32_t val = 0U;
+	nve32_t ret;
+
+	ret = mgbe_indir_wait(osi_core, port);
+	if (ret < 0) {
+		goto done;
+	}
+
+	osi_writela(osi_core, data, base + p->data_reg);
+
+	if (ctrl_mask != 0xFFFFFFFFU) {
+		val = osi_readla(osi_core, base + p->ctrl_reg);
+		val &= ~ctrl_mask;
+	}
+	val |= (ctrl & ctrl_mask) | p->busy;
+	osi_writela(osi_core, val, base + p->ctrl_reg);
+
+	l_core->indir_pending |= OSI_BIT(port);
+
+done:
 	return ret;
 }
 
@@ -90,40 +179,22 @@ static nve32_t mgbe_mac_indir_addr_write(struct osi_core_priv_data *osi_core,
 					 nveu32_t addr_offset,
 					 nveu32_t value)
 {
-	void *base = osi_core->base;
 	nveu32_t addr = 0;
 	nve32_t ret = 0;
 
-	/* Write MAC_Indir_Access_Data register value */
-	osi_writela(osi_core, value, (nveu8_t *)base + MGBE_MAC_INDIR_DATA);
-
-	/* Program MAC_Indir_Access_Ctrl */
-	addr = osi_readla(osi_core, (nveu8_t *)base + MGBE_MAC_INDIR_AC);
-
-	/* update Mode Select */
-	addr &= ~(MGBE_MAC_INDIR_AC_MSEL);
+	/* update Mode Select and Address Offset, CMD bit 0 for write */
 	addr |= ((mc_no << MGBE_MAC_INDIR_AC_MSEL_SHIFT) &
 		  MGBE_MAC_INDIR_AC_MSEL);
-
-	/* update Address Offset */
-	addr &= ~(MGBE_MAC_INDIR_AC_AOFF);
 	addr |= ((addr_offset << MGBE_MAC_INDIR_AC_AOFF_SHIFT) &
 		  MGBE_MAC_INDIR_AC_AOFF);
 
-	/* Set CMD filed bit 0 for write */
-	addr &= ~(MGBE_MAC_INDIR_AC_CMD);
-
-	/* Set OB bit to initiate write */
-	addr |= MGBE_MAC_INDIR_AC_OB;
-
-	/* Write MGBE_MAC_L3L4_ADDR_CTR */
-	osi_writela(osi_core, addr, (nveu8_t *)base + MGBE_MAC_INDIR_AC);
-
-	/* Wait until OB bit reset */
-	if (mgbe_poll_for_mac_acrtl(osi_core) < 0) {
+	ret = mgbe_indir_issue(osi_core, MGBE_INDIR_MAC_AC, value,
+			       (MGBE_MAC_INDIR_AC_MSEL |
+				MGBE_MAC_INDIR_AC_AOFF |
+				MGBE_MAC_INDIR_AC_CMD), addr);
+	if (ret < 0) {
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			     "Fail to write MAC_Indir_Access_Ctrl\n", mc_no);
-		ret = -1;
 	}
 
 	return ret;
@@ -153,33 +224,25 @@ static nve32_t mgbe_mac_indir_addr_read(struct osi_core_priv_data *osi_core,
 	nveu32_t addr = 0;
 	nve32_t ret = 0;
 
-	/* Program MAC_Indir_Access_Ctrl */
-	addr = osi_readla(osi_core, (nveu8_t *)base + MGBE_MAC_INDIR_AC);
-
-	/* update Mode Select */
-	addr &= ~(MGBE_MAC_INDIR_AC_MSEL);
+	/* update Mode Select and Address Offset, CMD bit 1 for read */
 	addr |= ((mc_no << MGBE_MAC_INDIR_AC_MSEL_SHIFT) &
 		  MGBE_MAC_INDIR_AC_MSEL);
-
-	/* update Address Offset */
-	addr &= ~(MGBE_MAC_INDIR_AC_AOFF);
 	addr |= ((addr_offset << MGBE_MAC_INDIR_AC_AOFF_SHIFT) &
 		  MGBE_MAC_INDIR_AC_AOFF);
-
-	/* Set CMD filed bit to 1 for read */
 	addr |= MGBE_MAC_INDIR_AC_CMD;
 
-	/* Set OB bit to initiate write */
-	addr |= MGBE_MAC_INDIR_AC_OB;
-
-	/* Write MGBE_MAC_L3L4_ADDR_CTR */
-	osi_writela(osi_core, addr, (nveu8_t *)base + MGBE_MAC_INDIR_AC);
+	ret = mgbe_indir_issue(osi_core, MGBE_INDIR_MAC_AC, 0U,
+			       (MGBE_MAC_INDIR_AC_MSEL |
+				MGBE_MAC_INDIR_AC_AOFF |
+				MGBE_MAC_INDIR_AC_CMD), addr);
+	if (ret == 0) {
+		/* Wait until OB bit reset */
+		ret = mgbe_indir_wait(osi_core, MGBE_INDIR_MAC_AC);
+	}
 
-	/* Wait until OB bit reset */
-	if (mgbe_poll_for_mac_acrtl(osi_core) < 0) {
+	if (ret < 0) {
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			     "Fail to write MAC_Indir_Access_Ctrl\n", mc_no);
-		ret = -1;
 		goto fail;
 	}
 
@@ -377,52 +440,9 @@ static nve32_t mgbe_update_mac_addr_low_high_reg(
 		xdcs_check |= (OSI_BIT(dma_chan) | dma_chansel);
 		ret = mgbe_mac_indir_addr_write(osi_core, MGBE_MAC_DCHSEL, idx, xdcs_check);
 	}
-fail:
-	return ret;
-}
 
-/**
- * @brief mgbe_poll_for_l3l4crtl - Poll for L3_L4 filter register operations.
- *
- * Algorithm: Waits for waits for transfer busy bit to be cleared in
- * L3_L4 address control register to complete filter register operations.
- *
- * @param[in] osi_core: osi core priv data structure
- *
- * @note MAC needs to be out of reset and proper clock configured.
- *
- * @retval 0 on success
- * @retval -1 on failure.
- */
-static nve32_t mgbe_poll_for_l3l4crtl(struct osi_core_priv_data *osi_core)
-{
-	nveu32_t retry = 10;
-	nveu32_t count;
-	nveu32_t l3l4_addr_ctrl = 0;
-	nve32_t cond = 1;
-	nve32_t ret = 0;
-
-	/* Poll Until L3_L4_Address_Control XB is clear */
-	count = 0;
-	while (cond == 1) {
-		if (count > retry) {
-			/* Return error after max retries */
-			ret = -1;
-			goto fail;
-		}
-
-		count++;
-
-		l3l4_addr_ctrl = osi_readla(osi_core,
-					    (nveu8_t *)osi_core->base +
-					    MGBE_MAC_L3L4_ADDR_CTR);
-		if ((l3l4_addr_ctrl & MGBE_MAC_L3L4_ADDR_CTR_XB) == OSI_NONE) {
-			/* Set cond to 0 to exit loop */
-			cond = 0;
-		} else {
-			/* wait for 10 usec for XB clear */
-			osi_core->osd_ops.udelay(MGBE_MAC_XB_WAIT);
-		}
+	if (ret == 0) {
+		ret = mgbe_indir_wait(osi_core, MGBE_INDIR_MAC_AC);
 	}
 fail:
 	return ret;
@@ -448,44 +468,23 @@ static nve32_t mgbe_l3l4_filter_write(struct osi_core_priv_data *osi_core,
 				      nveu32_t filter_type,
 				      nveu32_t value)
 {
-	void *base = osi_core->base;
 	nveu32_t addr = 0;
 	nve32_t ret = 0;
 
-	/* Write MAC_L3_L4_Data register value */
-	osi_writela(osi_core, value,
-		    (nveu8_t *)base + MGBE_MAC_L3L4_DATA);
-
-	/* Program MAC_L3_L4_Address_Control */
-	addr = osi_readla(osi_core,
-			  (nveu8_t *)base + MGBE_MAC_L3L4_ADDR_CTR);
-
-	/* update filter number */
-	addr &= ~(MGBE_MAC_L3L4_ADDR_CTR_IDDR_FNUM);
+	/* update filter number and type, TT 0 for write */
 	addr |= ((filter_no << MGBE_MAC_L3L4_ADDR_CTR_IDDR_FNUM_SHIFT) &
 		  MGBE_MAC_L3L4_ADDR_CTR_IDDR_FNUM);
-
-	/* update filter type */
-	addr &= ~(MGBE_MAC_L3L4_ADDR_CTR_IDDR_FTYPE);
 	addr |= ((filter_type << MGBE_MAC_L3L4_ADDR_CTR_IDDR_FTYPE_SHIFT) &
 		  MGBE_MAC_L3L4_ADDR_CTR_IDDR_FTYPE);
 
-	/* Set TT filed 0 for write */
-	addr &= ~(MGBE_MAC_L3L4_ADDR_CTR_TT);
-
-	/* Set XB bit to initiate write */
-	addr |= MGBE_MAC_L3L4_ADDR_CTR_XB;
-
-	/* Write MGBE_MAC_L3L4_ADDR_CTR */
-	osi_writela(osi_core, addr,
-		    (nveu8_t *)base + MGBE_MAC_L3L4_ADDR_CTR);
-
-	/* Wait untile XB bit reset */
-	if (mgbe_poll_for_l3l4crtl(osi_core) < 0) {
+	ret = mgbe_indir_issue(osi_core, MGBE_INDIR_L3L4, value,
+			       (MGBE_MAC_L3L4_ADDR_CTR_IDDR_FNUM |
+				MGBE_MAC_L3L4_ADDR_CTR_IDDR_FTYPE |
+				MGBE_MAC_L3L4_ADDR_CTR_TT), addr);
+	if (ret < 0) {
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			     "Fail to write L3_L4_Address_Control\n",
 			     filter_type);
-		ret = -1;
 	}
 
 	return ret;
@@ -582,6 +581,12 @@ static nve32_t mgbe_config_l3l4_filters(struct osi_core_priv_data *const osi_cor
 		goto exit_func;
 	}
 
+	/* Single wait for the whole filter update */
+	err = mgbe_indir_wait(osi_core, MGBE_INDIR_L3L4);
+	if (err < 0) {
+		goto exit_func;
+	}
+
 	/* success */
 	ret = 0;
 
@@ -869,6 +874,11 @@ static nve32_t mgbe_config_frp(struct osi_core_priv_data *const osi_core,
 		goto done;
 	}
 
+	ret = mgbe_indir_wait(osi_core, MGBE_INDIR_FRP);
+	if (ret < 0) {
+		goto done;
+	}
+
 	op_mode = osi_readla(osi_core, base + MGBE_MTL_OP_MODE);
 	if (enabled == OSI_ENABLE) {
 		/* Set FRPE bit of MTL_Operation_Mode register */
@@ -955,7 +965,6 @@ static nve32_t mgbe_frp_write(struct osi_core_priv_data *osi_core,
 			      nveu32_t data)
 {
 	nve32_t ret = 0;
-	nveu8_t *base = osi_core->base;
 	nveu32_t val = 0U;
 
 	if ((acc_sel != OSI_ENABLE) && (acc_sel != OSI_DISABLE)) {
@@ -966,56 +975,22 @@ static nve32_t mgbe_frp_write(struct osi_core_priv_data *osi_core,
 		goto done;
 	}
 
-	/* Wait for ready */
-	ret = osi_readl_poll_timeout((base + MGBE_MTL_RXP_IND_CS),
-				     (osi_core->osd_ops.udelay),
-				     (val),
-				     ((val & MGBE_MTL_RXP_IND_CS_BUSY) ==
-				      OSI_NONE),
-				     (MGBE_MTL_FRP_READ_UDELAY),
-				     (MGBE_MTL_FRP_READ_RETRY));
-	if (ret < 0) {
-		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
-			"Fail to write\n",
-			val);
-		ret = -1;
-		goto done;
-	}
-
-	/* Write data into MTL_RXP_Indirect_Acc_Data */
-	osi_writela(osi_core, data, base + MGBE_MTL_RXP_IND_DATA);
-
-	/* Program MTL_RXP_Indirect_Acc_Control_Status */
-	val = osi_readla(osi_core, base + MGBE_MTL_RXP_IND_CS);
-	/* Set/Reset ACCSEL for FRP Register block/Instruction Table */
+	/* Set/Reset ACCSEL for FRP Register block/Instruction Table,
+	 * WRRDN for write and ADDR
+	 */
 	if (acc_sel == OSI_ENABLE) {
-		/* Set ACCSEL bit */
 		val |= MGBE_MTL_RXP_IND_CS_ACCSEL;
-	} else {
-		/* Reset ACCSEL bit */
-		val &= ~MGBE_MTL_RXP_IND_CS_ACCSEL;
 	}
-	/* Set WRRDN for write */
 	val |= MGBE_MTL_RXP_IND_CS_WRRDN;
-	/* Clear and add ADDR */
-	val &= ~MGBE_MTL_RXP_IND_CS_ADDR;
 	val |= (addr & MGBE_MTL_RXP_IND_CS_ADDR);
-	/* Start write */
-	val |= MGBE_MTL_RXP_IND_CS_BUSY;
-	osi_writela(osi_core, val, base + MGBE_MTL_RXP_IND_CS);
-
-	/* Wait for complete */
-	ret = osi_readl_poll_timeout((base + MGBE_MTL_RXP_IND_CS),
-				     (osi_core->osd_ops.udelay),
-				     (val),
-				     ((val & MGBE_MTL_RXP_IND_CS_BUSY) ==
-				      OSI_NONE),
-				     (MGBE_MTL_FRP_READ_UDELAY),
-				     (MGBE_MTL_FRP_READ_RETRY));
+	ret = mgbe_indir_issue(osi_core, MGBE_INDIR_FRP, data,
+			       (MGBE_MTL_RXP_IND_CS_ACCSEL |
+				MGBE_MTL_RXP_IND_CS_WRRDN |
+				MGBE_MTL_RXP_IND_CS_ADDR), val);
 	if (ret < 0) {
 		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
 			"Fail to write\n",
-			val);
+			addr);
 		ret = -1;
 	}
 
@@ -1143,6 +1118,12 @@ static nve32_t mgbe_update_frp_nve(struct osi_core_priv_data *const osi_core,
 		goto done;
 	}
 
+	/* Instruction writes issued so far have to land before NVE moves */
+	ret = mgbe_indir_wait(osi_core, MGBE_INDIR_FRP);
+	if (ret < 0) {
+		goto done;
+	}
+
 	/* Update NVE and NPE in MTL_RXP_Control_Status register */
 	val = osi_readla(osi_core, base + MGBE_MTL_RXP_CS);
 	/* Clear old NVE and NPE */
@@ -1214,6 +1195,10 @@ static nve32_t mgbe_configure_mtl_queue(struct osi_core_priv_data *osi_core,
 		FULL_MINUS_1_5K,
 		FULL_MINUS_1_5K,
 	};
+#ifndef OSI_STRIPPED_LIB
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
+#endif /* !OSI_STRIPPED_LIB */
+	nveu32_t rx_fifo, tx_fifo, rfa, rfd;
 	nveu32_t value = 0;
 	nve32_t ret = 0;
 
@@ -1249,7 +1234,21 @@ static nve32_t mgbe_configure_mtl_queue(struct osi_core_priv_data *osi_core,
 		goto fail;
 	}
 
-	value = (tx_fifo_sz[qinx] << MGBE_MTL_TXQ_SIZE_SHIFT);
+	tx_fifo = tx_fifo_sz[qinx];
+	rx_fifo = rx_fifo_sz[qinx];
+	rfa = rfd_rfa[qinx];
+	rfd = rfd_rfa[qinx];
+#ifndef OSI_STRIPPED_LIB
+	/* FIFO layout planned from queue profiles */
+	if (l_core->mtl_fifo_auto == OSI_ENABLE) {
+		tx_fifo = l_core->mtl_tx_fifo[qinx];
+		rx_fifo = l_core->mtl_rx_fifo[qinx];
+		rfa = l_core->mtl_rfa[qinx];
+		rfd = l_core->mtl_rfd[qinx];
+	}
+#endif /* !OSI_STRIPPED_LIB */
+
+	value = (tx_fifo << MGBE_MTL_TXQ_SIZE_SHIFT);
 	/* Enable Store and Forward mode */
 	value |= MGBE_MTL_TSF;
 	/*TTC  not applicable for TX*/
@@ -1262,7 +1261,7 @@ static nve32_t mgbe_configure_mtl_queue(struct osi_core_priv_data *osi_core,
 	/* read RX Q0 Operating Mode Register */
 	value = osi_readla(osi_core, (nveu8_t *)osi_core->base +
 			  MGBE_MTL_CHX_RX_OP_MODE(qinx));
-	value |= (rx_fifo_sz[qinx] << MGBE_MTL_RXQ_SIZE_SHIFT);
+	value |= (rx_fifo << MGBE_MTL_RXQ_SIZE_SHIFT);
 	/* Enable Store and Forward mode */
 	value |= MGBE_MTL_RSF;
 	/* Enable HW flow control */
@@ -1279,8 +1278,8 @@ static nve32_t mgbe_configure_mtl_queue(struct osi_core_priv_data *osi_core,
 			  MGBE_MTL_RXQ_FLOW_CTRL(qinx));
 	value &= ~MGBE_MTL_RXQ_OP_MODE_RFD_MASK;
 	value &= ~MGBE_MTL_RXQ_OP_MODE_RFA_MASK;
-	value |= (rfd_rfa[qinx] << MGBE_MTL_RXQ_OP_MODE_RFD_SHIFT) & MGBE_MTL_RXQ_OP_MODE_RFD_MASK;
-	value |= (rfd_rfa[qinx] << MGBE_MTL_RXQ_OP_MODE_RFA_SHIFT) & MGBE_MTL_RXQ_OP_MODE_RFA_MASK;
+	value |= (rfd << MGBE_MTL_RXQ_OP_MODE_RFD_SHIFT) & MGBE_MTL_RXQ_OP_MODE_RFD_MASK;
+	value |= (rfa << MGBE_MTL_RXQ_OP_MODE_RFA_SHIFT) & MGBE_MTL_RXQ_OP_MODE_RFA_MASK;
 	osi_writela(osi_core, value, (nveu8_t *)osi_core->base +
 		   MGBE_MTL_RXQ_FLOW_CTRL(qinx));
 
@@ -1331,50 +1330,149 @@ static nve32_t mgbe_rss_write_reg(struct osi_core_priv_data *osi_core,
 				  nveu32_t value,
 				  nveu32_t is_key)
 {
-	nveu8_t *addr = (nveu8_t *)osi_core->base;
-	nveu32_t retry = 100;
 	nveu32_t ctrl = 0;
-	nveu32_t count = 0;
-	nve32_t cond = 1;
-
-	/* data into RSS Lookup Table or RSS Hash Key */
-	osi_writela(osi_core, value, addr + MGBE_MAC_RSS_DATA);
+	nve32_t ret;
 
 	if (is_key == OSI_ENABLE) {
 		ctrl |= MGBE_MAC_RSS_ADDR_ADDRT;
 	}
 
 	ctrl |= idx << MGBE_MAC_RSS_ADDR_RSSIA_SHIFT;
-	ctrl |= MGBE_MAC_RSS_ADDR_OB;
 	ctrl &= ~MGBE_MAC_RSS_ADDR_CT;
-	osi_writela(osi_core, ctrl, addr + MGBE_MAC_RSS_ADDR);
 
-	/* poll for write operation to complete */
-	while (cond == 1) {
-		if (count > retry) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
-				     "Failed to update RSS Hash key or table\n",
-				     0ULL);
-			return -1;
+	/* data into RSS Lookup Table or RSS Hash Key */
+	ret = mgbe_indir_issue(osi_core, MGBE_INDIR_RSS, value,
+			       0xFFFFFFFFU, ctrl);
+	if (ret < 0) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+			     "Failed to update RSS Hash key or table\n",
+			     0ULL);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief mgbe_update_rss_table - Update RSS table entries
+ *
+ * Algorithm: Write RSS table entries of osi_core->rss.table which
+ * differ from old, all entries if old is NULL, and wait once for the
+ * batch to complete.
+ *
+ * @param[in] osi_core: OSI core private data.
+ * @param[in] old: RSS table as programmed in HW, or NULL.
+ *
+ * @note MAC has to be out of reset.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t mgbe_update_rss_table(struct osi_core_priv_data *osi_core,
+				     const nveu32_t *const old)
+{
+	nveu32_t i;
+	nve32_t ret = 0;
+
+	for (i = 0; i < OSI_RSS_MAX_TABLE_SIZE; i++) {
+		if ((old != OSI_NULL) && (old[i] == osi_core->rss.table[i])) {
+			continue;
 		}
 
-		count++;
+		ret = mgbe_rss_write_reg(osi_core, i, osi_core->rss.table[i],
+					 OSI_NONE);
+		if (ret < 0) {
+			goto done;
+		}
+	}
 
-		value = osi_readla(osi_core, addr + MGBE_MAC_RSS_ADDR);
-		if ((value & MGBE_MAC_RSS_ADDR_OB) == OSI_NONE) {
-			cond = 0;
-		} else {
-			osi_core->osd_ops.udelay(100);
+	ret = mgbe_indir_wait(osi_core, MGBE_INDIR_RSS);
+
+done:
+	return ret;
+}
+
+/**
+ * @brief mgbe_update_rss - Update parts of RSS configuration
+ *
+ * Algorithm: Write RSS hash key and/or full RSS table and wait once for
+ * the batch, then update hash field selection in MAC_RSS_Ctrl, as
+ * selected by upd.
+ *
+ * @param[in] osi_core: OSI core private data.
+ * @param[in] upd: OSI_RSS_UPD_* bits.
+ *
+ * @note MAC has to be out of reset.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t mgbe_update_rss(struct osi_core_priv_data *osi_core,
+			       const nveu32_t upd)
+{
+	nveu8_t *addr = (nveu8_t *)osi_core->base;
+	nveu32_t fields = osi_core->rss.hash_fields;
+	nveu32_t value = 0, ctrl;
+	nveu32_t i = 0, j = 0;
+	nve32_t ret = 0;
+
+	if ((upd & OSI_RSS_UPD_KEY) != OSI_NONE) {
+		/* Program the hash key */
+		for (i = 0; i < OSI_RSS_HASH_KEY_SIZE; i += 4U) {
+			value = ((nveu32_t)osi_core->rss.key[i] |
+				 ((nveu32_t)osi_core->rss.key[i + 1U] << 8U) |
+				 ((nveu32_t)osi_core->rss.key[i + 2U] << 16U) |
+				 ((nveu32_t)osi_core->rss.key[i + 3U] << 24U));
+			ret = mgbe_rss_write_reg(osi_core, j, value, OSI_ENABLE);
+			if (ret < 0) {
+				goto done;
+			}
+			j++;
 		}
 	}
 
-	return 0;
+	if ((upd & OSI_RSS_UPD_TABLE) != OSI_NONE) {
+		/* Program Hash table */
+		ret = mgbe_update_rss_table(osi_core, OSI_NULL);
+	} else {
+		ret = mgbe_indir_wait(osi_core, MGBE_INDIR_RSS);
+	}
+	if (ret < 0) {
+		goto done;
+	}
+
+	if ((upd & OSI_RSS_UPD_FIELDS) != OSI_NONE) {
+		if (fields == OSI_NONE) {
+			fields = OSI_RSS_HASH_DEFAULT;
+		}
+
+		value = osi_readla(osi_core, addr + MGBE_MAC_RSS_CTRL);
+		ctrl = value & ~(MGBE_MAC_RSS_CTRL_UDP4TE |
+				 MGBE_MAC_RSS_CTRL_TCP4TE |
+				 MGBE_MAC_RSS_CTRL_IP2TE);
+		if ((fields & OSI_RSS_HASH_IP) != OSI_NONE) {
+			ctrl |= MGBE_MAC_RSS_CTRL_IP2TE;
+		}
+		if ((fields & OSI_RSS_HASH_TCP) != OSI_NONE) {
+			ctrl |= MGBE_MAC_RSS_CTRL_TCP4TE;
+		}
+		if ((fields & OSI_RSS_HASH_UDP) != OSI_NONE) {
+			ctrl |= MGBE_MAC_RSS_CTRL_UDP4TE;
+		}
+
+		if (ctrl != value) {
+			osi_writela(osi_core, ctrl, addr + MGBE_MAC_RSS_CTRL);
+		}
+	}
+
+done:
+	return ret;
 }
 
 /**
  * @brief mgbe_config_rss - Configure RSS
  *
- * Algorithm: Programes RSS hash table or RSS hash key.
+ * Algorithm: Programes RSS hash key, table and hash field selection
+ * and enables RSS.
  *
  * @param[in] osi_core: OSI core private data.
  *
@@ -1387,7 +1485,6 @@ static nve32_t mgbe_config_rss(struct osi_core_priv_data *osi_core)
 {
 	nveu8_t *addr = (nveu8_t *)osi_core->base;
 	nveu32_t value = 0;
-	nveu32_t i = 0, j = 0;
 	nve32_t ret = 0;
 
 	if (osi_core->rss.enable == OSI_DISABLE) {
@@ -1400,32 +1497,15 @@ static nve32_t mgbe_config_rss(struct osi_core_priv_data *osi_core)
 		return 0;
 	}
 
-	/* Program the hash key */
-	for (i = 0; i < OSI_RSS_HASH_KEY_SIZE; i += 4U) {
-		value = ((nveu32_t)osi_core->rss.key[i] |
-			 ((nveu32_t)osi_core->rss.key[i + 1U] << 8U) |
-			 ((nveu32_t)osi_core->rss.key[i + 2U] << 16U) |
-			 ((nveu32_t)osi_core->rss.key[i + 3U] << 24U));
-		ret = mgbe_rss_write_reg(osi_core, j, value, OSI_ENABLE);
-		if (ret < 0) {
-			return ret;
-		}
-		j++;
-	}
-
-	/* Program Hash table */
-	for (i = 0; i < OSI_RSS_MAX_TABLE_SIZE; i++) {
-		ret = mgbe_rss_write_reg(osi_core, i, osi_core->rss.table[i],
-					 OSI_NONE);
-		if (ret < 0) {
-			return ret;
-		}
+	ret = mgbe_update_rss(osi_core, (OSI_RSS_UPD_KEY | OSI_RSS_UPD_TABLE |
+					 OSI_RSS_UPD_FIELDS));
+	if (ret < 0) {
+		return ret;
 	}
 
 	/* Enable RSS */
 	value = osi_readla(osi_core, addr + MGBE_MAC_RSS_CTRL);
-	value |= MGBE_MAC_RSS_CTRL_UDP4TE | MGBE_MAC_RSS_CTRL_TCP4TE |
-		 MGBE_MAC_RSS_CTRL_IP2TE | MGBE_MAC_RSS_CTRL_RSSE;
+	value |= MGBE_MAC_RSS_CTRL_RSSE;
 	osi_writela(osi_core, value, addr + MGBE_MAC_RSS_CTRL);
 
 	return 0;
@@ -1728,6 +1808,59 @@ static nve32_t mgbe_hsi_inject_err(struct osi_core_priv_data *const osi_core,
 }
 #endif
 
+/**
+ * @brief mgbe_configure_rxq_priority - Configure Priorities Selected in
+ *    the Receive Queue
+ *
+ * Algorithm: Program PSRQ field of MAC_RxQ_Ctrl2/3 of each enabled RX
+ *	queue from rxq_prio, PSRQ exists for queues 0 to 7 only. A queue
+ *	without priorities is left at 0, a priority mask which is invalid or
+ *	overlaps the mask of a queue programmed before is skipped, as done
+ *	for EQOS.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ *
+ * @note MAC has to be out of reset.
+ */
+static void mgbe_configure_rxq_priority(
+				struct osi_core_priv_data *const osi_core)
+{
+	nveu8_t *base = (nveu8_t *)osi_core->base;
+	nveu32_t qinx, mtlq, prio, val;
+	nveu32_t pmask = 0x0U;
+
+	/* make sure MAC_RxQ_Ctrl2/3 are reset before programming */
+	osi_writela(osi_core, OSI_DISABLE, base + MAC_RQC2R(0U));
+	osi_writela(osi_core, OSI_DISABLE, base + MAC_RQC2R(4U));
+
+	for (qinx = 0U; qinx < osi_core->num_mtl_queues; qinx++) {
+		mtlq = osi_core->mtl_queues[qinx];
+		if (mtlq >= OSI_EQOS_MAX_NUM_QUEUES) {
+			/* No PSRQ field for this queue */
+			continue;
+		}
+
+		prio = osi_core->rxq_prio[mtlq];
+		if (prio == 0x0U) {
+			continue;
+		}
+
+		/* check for PSRQ field mutual exclusive for all queues */
+		if ((prio > MAC_RQC2R_PSRQ_MASK) || ((pmask & prio) != 0U)) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "Invalid rxq Priority for Q\n",
+				     (nveul64_t)mtlq);
+			continue;
+		}
+		pmask |= prio;
+
+		val = osi_readla(osi_core, base + MAC_RQC2R(mtlq));
+		val &= ~(MAC_RQC2R_PSRQ_MASK << RXQ_FIELD_SHIFT(mtlq));
+		val |= (prio << RXQ_FIELD_SHIFT(mtlq));
+		osi_writela(osi_core, val, base + MAC_RQC2R(mtlq));
+	}
+}
+
 /**
  * @brief mgbe_configure_mac - Configure MAC
  *
@@ -1735,7 +1868,8 @@ static nve32_t mgbe_hsi_inject_err(struct osi_core_priv_data *const osi_core,
  *	parameters for the MAC
  *	1) Programming the MAC address
  *	2) Enable required MAC control fields in MCR
- *	3) Enable Multicast and Broadcast Queue
+ *	3) Enable Multicast and Broadcast Queue, map user priorities to
+ *	   RX queues
  *	4) Disable MMC nve32_terrupts and Configure the MMC counters
  *	5) Enable required MAC nve32_terrupts
  *
@@ -1807,6 +1941,11 @@ static nve32_t mgbe_configure_mac(struct osi_core_priv_data *osi_core)
 	osi_writela(osi_core, value,
 		    (nveu8_t *)osi_core->base + MGBE_MAC_RQC1R);
 
+	/* USP (user Priority) to RxQ Mapping, only if DCS not enabled */
+	if (osi_core->dcs_en != OSI_ENABLE) {
+		mgbe_configure_rxq_priority(osi_core);
+	}
+
 	/* Disable all MMC nve32_terrupts */
 	/* Disable all MMC Tx nve32_terrupts */
 	osi_writela(osi_core, OSI_NONE, (nveu8_t *)osi_core->base +
@@ -2119,12 +2258,20 @@ static void mgbe_handle_mac_fpe_intrs(struct osi_core_priv_data *osi_core)
 		val &= ~MGBE_MAC_FPE_CTS_RRSP;
 		val &= ~MGBE_MAC_FPE_CTS_TVER;
 		osi_core->fpe_ready = OSI_ENABLE;
+#ifndef OSI_STRIPPED_LIB
+		osi_core->stats.fpe_verify_ok_n =
+			osi_update_stats_counter(osi_core->stats.fpe_verify_ok_n, 1UL);
+#endif /* !OSI_STRIPPED_LIB */
 		val |= MGBE_MAC_FPE_CTS_EFPE;
 	}
 
 	if ((val & MGBE_MAC_FPE_CTS_TRSP) == MGBE_MAC_FPE_CTS_TRSP) {
 		/* TX response packet sucessful */
 		osi_core->fpe_ready = OSI_ENABLE;
+#ifndef OSI_STRIPPED_LIB
+		osi_core->stats.fpe_verify_ok_n =
+			osi_update_stats_counter(osi_core->stats.fpe_verify_ok_n, 1UL);
+#endif /* !OSI_STRIPPED_LIB */
 		/* Enable frame preemption */
 		val &= ~MGBE_MAC_FPE_CTS_TRSP;
 		val &= ~MGBE_MAC_FPE_CTS_TVER;
@@ -4050,6 +4197,8 @@ void mgbe_init_core_ops(struct core_ops *ops)
 	ops->set_mdc_clk_rate = mgbe_set_mdc_clk_rate;
 	ops->config_mac_loopback = mgbe_config_mac_loopback;
 	ops->config_rss = mgbe_config_rss;
+	ops->update_rss_table = mgbe_update_rss_table;
+	ops->update_rss = mgbe_update_rss;
 	ops->config_ptp_rxq = mgbe_config_ptp_rxq;
 #endif /* !OSI_STRIPPED_LIB */
 #ifdef HSI_SUPPORT
@@ -97,6 +97,8 @@
 #define MGBE_MAC_RSS_ADDR_RSSIA_SHIFT		8U
 #define MGBE_MAC_RSS_ADDR_OB			OSI_BIT(0)
 #define MGBE_MAC_RSS_ADDR_CT			OSI_BIT(1)
+#define MGBE_MAC_RSS_OB_WAIT			100U
+#define MGBE_MAC_RSS_OB_RETRY			100U
 /**
  * @addtogroup - MGBE-LPI LPI configuration macros
  *
@@ -359,6 +361,10 @@
 #define MGBE_MAC_TSSEC			0x0D34
 #define MGBE_MAC_TSPKID			0x0D38
 #define MGBE_MAC_PPS_CTL		0x0D70
+#define MGBE_MAC_PPS_TTSR(x)		((0x0010U * (x)) + 0x0D80U)
+#define MGBE_MAC_PPS_TTNSR(x)		((0x0010U * (x)) + 0x0D84U)
+#define MGBE_MAC_PPS_INTERVAL(x)	((0x0010U * (x)) + 0x0D88U)
+#define MGBE_MAC_PPS_WIDTH(x)		((0x0010U * (x)) + 0x0D8CU)
 /** @} */
 
 /**
@@ -389,6 +395,23 @@
 /** @} */
 
 
+/**
+ * @addtogroup MGBE-INDIR Indirect access ports
+ *
+ * @brief MGBE indirect access port indexes
+ * @{
+ */
+#define MGBE_INDIR_MAC_AC		0U
+#define MGBE_INDIR_L3L4			1U
+#define MGBE_INDIR_FRP			2U
+#ifndef OSI_STRIPPED_LIB
+#define MGBE_INDIR_RSS			3U
+#define MGBE_INDIR_MAX			4U
+#else
+#define MGBE_INDIR_MAX			3U
+#endif /* !OSI_STRIPPED_LIB */
+/** @} */
+
 /**
  * @addtogroup MGBE-MAC-MODE MAC Mode Select Group
  *
@@ -423,6 +446,7 @@
  * @{
  */
 #define MGBE_MAC_XB_WAIT		10U
+#define MGBE_MAC_XB_RETRY		10U
 #define MGBE_MAC_L3L4_CTR		0x0
 #define MGBE_MAC_L3_AD1R		0x5
 #ifndef OSI_STRIPPED_LIB
@@ -460,10 +484,12 @@
 #define MGBE_MTL_RXQ_DMA_MAP0		0x1030
 #define MGBE_MTL_RXQ_DMA_MAP1		0x1034
 #define MGBE_MTL_RXQ_DMA_MAP2		0x1038
+#define MGBE_MTL_TCPM0R			0x1040
 #define MGBE_MTL_CHX_TX_OP_MODE(x)	((0x0080U * (x)) + 0x1100U)
 #define MGBE_MTL_TCQ_ETS_CR(x)		((0x0080U * (x)) + 0x1110U)
 #define MGBE_MTL_TCQ_QW(x)		((0x0080U * (x)) + 0x1118U)
 #define MGBE_MTL_CHX_RX_OP_MODE(x)	((0x0080U * (x)) + 0x1140U)
+#define MGBE_MTL_CHX_RX_DEBUG(x)	((0x0080U * (x)) + 0x1148U)
 #define MGBE_MTL_RXQ_FLOW_CTRL(x)	((0x0080U * (x)) + 0x1150U)
 /** @} */
 
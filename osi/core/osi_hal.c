@@ -33,6 +33,9 @@
 #endif /* OSI_DEBUG */
 #ifndef OSI_STRIPPED_LIB
 #include "vlan_filter.h"
+#include "rss.h"
+#include "est_plan.h"
+#include "cbs.h"
 #endif
 /**
  * @brief g_ops - Static core operations array.
@@ -284,6 +287,7 @@ exit:
  */
 static inline void init_vlan_filters(struct osi_core_priv_data *const osi_core)
 {
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
 	nveu32_t i = 0U;
 
 	for (i = 0; i < VLAN_NUM_VID; i++) {
@@ -292,6 +296,10 @@ static inline void init_vlan_filters(struct osi_core_priv_data *const osi_core)
 
 	osi_core->vf_bitmap = 0U;
 	osi_core->vlan_filter_cnt = 0U;
+	osi_memset(l_core->vlan_set, 0, sizeof(l_core->vlan_set));
+	osi_memset(l_core->vlan_hw, 0, sizeof(l_core->vlan_hw));
+	l_core->vlan_dirty = 0U;
+	osi_memset(l_core->vlan_hash_cnt, 0, sizeof(l_core->vlan_hash_cnt));
 }
 #endif
 
@@ -425,11 +433,9 @@ static inline nveu64_t div_u64(nveu64_t dividend,
 static nve32_t osi_ptp_configuration(struct osi_core_priv_data *const osi_core,
 				     OSI_UNUSED const nveu32_t enable)
 {
-#ifndef OSI_STRIPPED_LIB
 	struct core_local *l_core = (struct core_local *)(void *)osi_core;
-#endif /* !OSI_STRIPPED_LIB */
 	nve32_t ret = 0;
-	nveu64_t temp = 0, temp1 = 0, temp2 = 0;
+	nveu64_t temp = 0, temp1 = 0;
 	nveu64_t ssinc = 0;
 
 #ifndef OSI_STRIPPED_LIB
@@ -463,20 +469,25 @@ static nve32_t osi_ptp_configuration(struct osi_core_priv_data *const osi_core,
 		temp = ((nveu64_t)1000 << 32);
 		temp = (nveu64_t)temp * 1000000U;
 
+		/* floor(floor(a / b) / c) == floor(a / (b * c)), so a single
+		 * division is enough for both clock rate and SSINC.
+		 */
 		temp1 = div_u64(temp,
-			(nveu64_t)osi_core->ptp_config.ptp_ref_clk_rate);
-
-		temp2 = div_u64(temp1, (nveu64_t)ssinc);
+			(nveu64_t)osi_core->ptp_config.ptp_ref_clk_rate * ssinc);
 
-		if (temp2 < UINT_MAX) {
-			osi_core->default_addend = (nveu32_t)temp2;
+		if (temp1 < UINT_MAX) {
+			osi_core->default_addend = (nveu32_t)temp1;
 		} else {
 			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				     "core: temp2 >= UINT_MAX\n", 0ULL);
+				     "core: temp1 >= UINT_MAX\n", 0ULL);
 			ret = -1;
 			goto fail;
 		}
 
+		/* Precompute addend change per ppb for osi_adjust_freq() */
+		l_core->addend_scale = div_u64(((nveu64_t)osi_core->default_addend << 32),
+					       OSI_NSEC_PER_SEC);
+
 		/* Program addend value */
 		ret = hw_config_addend(osi_core, osi_core->default_addend);
 
@@ -537,9 +548,23 @@ static nve32_t osi_hal_hw_core_init(struct osi_core_priv_data *const osi_core)
 		goto fail;
 	}
 
+	/* FRP instruction table content is unknown after MAC reset */
+	l_core->frp_hw_valid = OSI_DISABLE;
+	/* So is content of EST GCL memory banks */
+	l_core->est_bank[0].valid = OSI_DISABLE;
+	l_core->est_bank[1].valid = OSI_DISABLE;
+	/* No indirect access in flight after MAC reset */
+	l_core->indir_pending = 0U;
+
 #ifndef OSI_STRIPPED_LIB
+	/* FPE is off after MAC reset until configured again */
+	l_core->fpe_enabled = OSI_DISABLE;
 	init_vlan_filters(osi_core);
 
+	ret = hw_plan_mtl_fifo(osi_core);
+	if (ret < 0) {
+		goto fail;
+	}
 #endif /* !OSI_STRIPPED_LIB */
 
 	ret = l_core->ops_p->core_init(osi_core);
@@ -737,15 +762,311 @@ fail:
 	return ret;
 }
 
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief l2_hash_bit - Hash filter bit index of a MAC address
+ *
+ * @note
+ * Algorithm:
+ * - CRC-32 (reflected, poly 0xEDB88320) over the address.
+ * - Bit reverse the low nbits of the inverted CRC, same as HW.
+ *
+ * @param[in] addr: MAC address.
+ * @param[in] nbits: log2 of hash table size in bits.
+ *
+ * @retval hash table bit index
+ */
+static nveu32_t l2_hash_bit(const nveu8_t *const addr, nveu32_t nbits)
+{
+	nveu32_t crc = 0xFFFFFFFFU;
+	nveu32_t bit = 0U;
+	nveu32_t i, j;
+
+	for (i = 0U; i < OSI_ETH_ALEN; i++) {
+		crc ^= addr[i];
+		for (j = 0U; j < 8U; j++) {
+			if ((crc & OSI_BIT(0)) != 0U) {
+				crc = (crc >> 1U) ^ 0xEDB88320U;
+			} else {
+				crc >>= 1U;
+			}
+		}
+	}
+
+	crc = ~crc;
+	for (i = 0U; i < nbits; i++) {
+		bit = (bit << 1U) | ((crc >> i) & OSI_BIT(0));
+	}
+
+	return bit;
+}
+
+/**
+ * @brief l2_list_filter - Build perfect filter of an L2 address list entry
+ *
+ * @param[in] list: L2 address list.
+ * @param[in] idx: Address index in list.
+ * @param[in] slot: Perfect filter index.
+ * @param[in] oper_mode: OSI_OPER_ADDR_UPDATE or OSI_OPER_ADDR_DEL.
+ * @param[out] filter: Filter to fill.
+ */
+static void l2_list_filter(const struct osi_l2_addr_list *const list,
+			   nveu32_t idx, nveu32_t slot, nveu32_t oper_mode,
+			   struct osi_filter *const filter)
+{
+	osi_memset(filter, 0, sizeof(struct osi_filter));
+	filter->oper_mode = oper_mode;
+	filter->index = slot;
+	(void)osi_memcpy(filter->mac_address, &list->addr[idx * OSI_ETH_ALEN],
+			 OSI_ETH_ALEN);
+	filter->src_dest = OSI_DA_MATCH;
+	if (list->dma_chan != OSI_CHAN_ANY) {
+		filter->dma_routing = OSI_ENABLE;
+		filter->dma_chan = list->dma_chan;
+	}
+}
+
+/**
+ * @brief osi_l2_addr_list - Replace L2 DA filter address list
+ *
+ * @note
+ * Algorithm:
+ * - Perfect filter slots from start_idx are owned by the list, slot 0
+ *   holds the station address and can't be owned. Slots already holding
+ *   a listed address are kept, others are freed.
+ * - Remaining addresses are planned into free slots, then into freed
+ *   slots, overflow goes to the hash filter if HW has one. Nothing is
+ *   written if the list does not fit.
+ * - Planned slots are written one by one. If a write fails, the slots
+ *   written so far get their previous address back.
+ * - Only hash table registers which changed are written.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in, out] list: L2 address list, hash_cnt is updated.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t osi_l2_addr_list(struct osi_core_priv_data *const osi_core,
+				struct osi_l2_addr_list *const list)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	const nveu32_t max_filter[3] = {
+		EQOS_MAX_MAC_ADDRESS_FILTER,
+		EQOS_MAX_MAC_5_3_ADDRESS_FILTER,
+		OSI_MGBE_MAX_MAC_ADDRESS_FILTER
+	};
+	const nveu32_t max_chans[MAX_MAC_IP_TYPES] = {
+		OSI_EQOS_MAX_NUM_CHANS,
+		OSI_MGBE_MAX_NUM_CHANS
+	};
+	nveu8_t placed[OSI_MAX_L2_ADDR_LIST];
+	/* Per slot: L2_SLOT_* action and list index written into it */
+	nveu8_t act[EQOS_MAX_MAC_ADDRESS_FILTER];
+	nveu16_t src[EQOS_MAX_MAC_ADDRESS_FILTER];
+	nveu32_t htr[EQOS_MAX_HTR_REGS];
+	struct osi_filter filter;
+	nveu32_t max, nbits = 0U, nregs = 0U, pfr = 0U;
+	nveu32_t i, j, k, bit;
+	nve32_t ret = -1;
+
+	max = max_filter[l_core->l_mac_ver];
+	if ((list->start_idx == 0U) || (list->start_idx >= max) ||
+	    (list->count > OSI_MAX_L2_ADDR_LIST) ||
+	    ((list->count != 0U) && (list->addr == OSI_NULL))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid L2 address list\n",
+			     (nveul64_t)list->count);
+		goto fail;
+	}
+
+	if ((list->dma_chan != OSI_CHAN_ANY) &&
+	    ((list->dma_chan >= max_chans[osi_core->mac]) ||
+	     (osi_core->dcs_en != OSI_ENABLE))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid L2 address list DMA channel\n",
+			     (nveul64_t)list->dma_chan);
+		goto fail;
+	}
+
+	if ((osi_core->hw_feature != OSI_NULL) &&
+	    (osi_core->hw_feature->hash_tbl_sz != 0U) &&
+	    (osi_core->hw_feature->hash_tbl_sz <= 3U)) {
+		nbits = osi_core->hw_feature->hash_tbl_sz + 5U;
+		nregs = OSI_BIT(osi_core->hw_feature->hash_tbl_sz);
+	}
+
+	osi_memset(placed, 0, sizeof(placed));
+	osi_memset(act, L2_SLOT_KEEP, sizeof(act));
+	osi_memset(src, 0, sizeof(src));
+	osi_memset(htr, 0, sizeof(htr));
+	list->hash_cnt = 0U;
+
+	/* Keep slots already holding a listed address, free the others */
+	for (i = list->start_idx; i < max; i++) {
+		if (l_core->cfg.l2[i].used == OSI_DISABLE) {
+			continue;
+		}
+
+		for (j = 0U; j < list->count; j++) {
+			if ((placed[j] == OSI_DISABLE) &&
+			    (osi_memcmp(l_core->cfg.l2[i].filter.mac_address,
+					&list->addr[j * OSI_ETH_ALEN],
+					(nve32_t)OSI_ETH_ALEN) == 0)) {
+				placed[j] = OSI_ENABLE;
+				break;
+			}
+		}
+
+		if (j == list->count) {
+			act[i] = L2_SLOT_DEL;
+		}
+	}
+
+	/* Plan free slots first, then freed ones, overflow to hash filter */
+	i = list->start_idx;
+	k = list->start_idx;
+	for (j = 0U; j < list->count; j++) {
+		if (placed[j] == OSI_ENABLE) {
+			continue;
+		}
+
+		while ((i < max) && (l_core->cfg.l2[i].used == OSI_ENABLE)) {
+			i++;
+		}
+		while ((i == max) && (k < max) && (act[k] != L2_SLOT_DEL)) {
+			k++;
+		}
+
+		if (i < max) {
+			act[i] = L2_SLOT_ADD;
+			src[i] = (nveu16_t)j;
+			i++;
+			continue;
+		}
+
+		if (k < max) {
+			act[k] = L2_SLOT_ADD;
+			src[k] = (nveu16_t)j;
+			k++;
+			continue;
+		}
+
+		if (nbits == 0U) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_OUTOFBOUND,
+				     "No room for L2 address\n", (nveul64_t)j);
+			goto fail;
+		}
+
+		bit = l2_hash_bit(&list->addr[j * OSI_ETH_ALEN], nbits);
+		htr[bit >> 5U] |= OSI_BIT(bit & 0x1FU);
+		pfr |= (((list->addr[j * OSI_ETH_ALEN] & OSI_BIT(0)) != 0U) ?
+			MAC_PFR_HMC : MAC_PFR_HUC);
+		list->hash_cnt++;
+	}
+
+	/* Write planned slots, still one polled register update per slot */
+	for (i = list->start_idx; i < max; i++) {
+		if (act[i] == L2_SLOT_ADD) {
+			l2_list_filter(list, src[i], i, OSI_OPER_ADDR_UPDATE,
+				       &filter);
+		} else if (act[i] == L2_SLOT_DEL) {
+			(void)osi_memcpy(&filter, &l_core->cfg.l2[i].filter,
+					 sizeof(struct osi_filter));
+			filter.oper_mode = OSI_OPER_ADDR_DEL;
+		} else {
+			continue;
+		}
+
+		ret = l_core->ops_p->update_mac_addr_low_high_reg(osi_core,
+								  &filter);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	if (ret < 0) {
+		/* Put back the previous address of the slots written */
+		for (k = list->start_idx; k <= i; k++) {
+			if (act[k] == L2_SLOT_KEEP) {
+				continue;
+			}
+
+			if (l_core->cfg.l2[k].used == OSI_ENABLE) {
+				(void)osi_memcpy(&filter,
+						 &l_core->cfg.l2[k].filter,
+						 sizeof(struct osi_filter));
+				filter.oper_mode = OSI_OPER_ADDR_UPDATE;
+			} else {
+				l2_list_filter(list, src[k], k,
+					       OSI_OPER_ADDR_DEL, &filter);
+			}
+			(void)l_core->ops_p->update_mac_addr_low_high_reg(osi_core,
+									  &filter);
+		}
+		list->hash_cnt = 0U;
+		goto fail;
+	}
+
+	for (i = list->start_idx; i < max; i++) {
+		if (act[i] == L2_SLOT_ADD) {
+			l2_list_filter(list, src[i], i, OSI_OPER_ADDR_UPDATE,
+				       &l_core->cfg.l2[i].filter);
+			l_core->cfg.l2[i].used = OSI_ENABLE;
+		} else if (act[i] == L2_SLOT_DEL) {
+			l_core->cfg.l2[i].used = OSI_DISABLE;
+		} else {
+			/* Slot unchanged */
+		}
+	}
+
+	if ((nregs != 0U) || (l_core->l2_hash_pfr != 0U)) {
+		hw_config_l2_hash(osi_core, htr, l_core->l2_hash,
+				  (nregs != 0U) ? nregs : EQOS_MAX_HTR_REGS, pfr);
+		(void)osi_memcpy(l_core->l2_hash, htr, sizeof(htr));
+		l_core->l2_hash_pfr = pfr;
+	}
+	ret = 0;
+
+fail:
+	return ret;
+}
+#endif /* !OSI_STRIPPED_LIB */
+
+/**
+ * @brief l3l4_hash - function to hash l3l4 filter tuple
+ *
+ * @note
+ * Algorithm:
+ * - FNV-1a hash over the filter data compared by l3l4_find_match().
+ *
+ * @param[in] l3_l4: Pointer to l3 l4 filter structure (#osi_l3_l4_filter)
+ *
+ * @retval filter tuple hash
+ */
+static nveu32_t l3l4_hash(const struct osi_l3_l4_filter *const l3_l4)
+{
+	const nveu8_t *data = (const nveu8_t *)(const void *)&(l3_l4->data);
+	nveu32_t hash = L3L4_HASH_BASIS;
+	nveu32_t i;
+
+	for (i = 0U; i < (nveu32_t)sizeof(l3_l4->data); i++) {
+		hash ^= data[i];
+		hash *= L3L4_HASH_PRIME;
+	}
+
+	return hash;
+}
+
 /**
  * @brief l3l4_find_match - function to find filter match
  *
  * @note
  * Algorithm:
- * - Search through filter list l_core->cfg.l3_l4[] and find for a
- *   match with l3_l4 input data.
+ * - Take the first clear bit of l_core->l3l4_used as free_filter_no.
+ * - Compare l3_l4 input data only against used filters whose stored
+ *   tuple hash matches.
  * - Filter data matches, store the filter index into filter_no.
- * - Store first found filter index into free_filter_no.
  * - Return 0 on match.
  * - Return -1 on failure.
  *
@@ -769,8 +1090,9 @@ static nve32_t l3l4_find_match(const struct core_local *const l_core,
 {
 	nveu32_t i;
 	nve32_t ret = -1;
-	nveu32_t found_free_index = 0;
 	nve32_t filter_size = (nve32_t)sizeof(l3_l4->data);
+	nveu32_t hash = l3l4_hash(l3_l4);
+	nveu32_t used = l_core->l3l4_used;
 #if defined(L3L4_WILDCARD_FILTER)
 	nveu32_t start_idx = 1; /* leave first one for TCP wildcard */
 #else
@@ -781,18 +1103,22 @@ static nve32_t l3l4_find_match(const struct core_local *const l_core,
 	*free_filter_no = UINT_MAX;
 
 	for (i = start_idx; i <= max_filter_no; i++) {
-		if (l_core->cfg.l3_l4[i].filter_enb_dis == OSI_FALSE) {
-			/* filter not enabled, save free index */
-			if (found_free_index == 0U) {
-				*free_filter_no = i;
-				found_free_index = 1;
-			}
+		if ((used & OSI_BIT(i)) == 0U) {
+			/* first free index */
+			*free_filter_no = i;
+			break;
+		}
+	}
+
+	for (i = start_idx; i <= max_filter_no; i++) {
+		if (((used & OSI_BIT(i)) == 0U) ||
+		    (l_core->l3l4_hash[i] != hash)) {
 			continue;
 		}
 
 		if (osi_memcmp(&(l_core->cfg.l3_l4[i].data), &(l3_l4->data),
 			      filter_size) != 0) {
-			/* data do not match */
+			/* hash collision, data do not match */
 			continue;
 		}
 
@@ -933,6 +1259,8 @@ static nve32_t configure_l3l4_filter_helper(struct osi_core_priv_data *const osi
 		(void)osi_memcpy(cfg_l3_l4, l3_l4, sizeof(struct osi_l3_l4_filter));
 		OSI_CORE_INFO((osi_core->osd), (OSI_LOG_ARG_OUTOFBOUND),
 			("L3L4: ADD: "), (filter_no));
+		l_core->l3l4_hash[filter_no] = l3l4_hash(cfg_l3_l4);
+		l_core->l3l4_used |= OSI_BIT(filter_no);
 
 		/* update filter mask bit */
 		osi_core->l3l4_filter_bitmask |= ((nveu32_t)1U << (filter_no & 0x1FU));
@@ -944,6 +1272,7 @@ static nve32_t configure_l3l4_filter_helper(struct osi_core_priv_data *const osi
 		(void)osi_memset(cfg_l3_l4, 0, sizeof(struct osi_l3_l4_filter));
 		OSI_CORE_INFO((osi_core->osd), (OSI_LOG_ARG_OUTOFBOUND),
 			("L3L4: DELETE: "), (filter_no));
+		l_core->l3l4_used &= ~OSI_BIT(filter_no);
 
 		/* update filter mask bit */
 		osi_core->l3l4_filter_bitmask &= ~((nveu32_t)1U << (filter_no & 0x1FU));
@@ -1157,11 +1486,12 @@ exit_func:
  */
 static nve32_t osi_adjust_freq(struct osi_core_priv_data *const osi_core, nve32_t ppb)
 {
-	nveu64_t adj;
+	const struct core_local *l_core = (struct core_local *)(void *)osi_core;
 	nveu64_t temp;
 	nveu32_t diff = 0;
 	nveu32_t addend;
 	nveu32_t neg_adj = 0;
+	nveu32_t uppb;
 	nve32_t ret = -1;
 	nve32_t ppb1 = ppb;
 
@@ -1169,16 +1499,18 @@ static nve32_t osi_adjust_freq(struct osi_core_priv_data *const osi_core, nve32_
 	if (ppb1 < 0) {
 		neg_adj = 1U;
 		ppb1 = -ppb1;
-		adj = (nveu64_t)addend * (nveu32_t)ppb1;
-	} else {
-		adj = (nveu64_t)addend * (nveu32_t)ppb1;
 	}
+	uppb = (nveu32_t)ppb1;
 
 	/*
-	 * div_u64 will divide the "adj" by "1000000000ULL"
-	 * and return the quotient.
+	 * diff = (addend * ppb) / 10^9 computed with the precomputed
+	 * 32.32 fixed point addend_scale instead of a 64 bit division.
+	 * Scale is split in high and low words to keep products in
+	 * 64 bits for any ppb value. Result may be one less than exact
+	 * division which is within one addend LSB.
 	 */
-	temp = div_u64(adj, OSI_NSEC_PER_SEC);
+	temp = ((l_core->addend_scale >> 32) * uppb) +
+	       (((l_core->addend_scale & UINT_MAX) * uppb) >> 32);
 	if (temp < UINT_MAX) {
 		diff = (nveu32_t)temp;
 	} else {
@@ -1366,6 +1698,226 @@ static nve32_t vlan_id_update(struct osi_core_priv_data *const osi_core,
 	return update_vlan_id(osi_core, l_core->ops_p, vid);
 }
 
+/**
+ * @brief vlan_list_update - Add/Delete a list of VLAN IDs
+ *
+ * @note
+ * Algorithm:
+ *  - Update VLAN filter set for the whole list with a single HW filter
+ *    update and store VLAN IDs for restore.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] list: VLAN ID list.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t vlan_list_update(struct osi_core_priv_data *const osi_core,
+				const struct osi_vlan_list *const list)
+{
+	struct core_local *const l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t used = OSI_DISABLE;
+	nveu32_t i;
+	nve32_t ret = 0;
+
+	if ((osi_core->mac_ver == OSI_EQOS_MAC_4_10) ||
+	    (osi_core->mac_ver == OSI_EQOS_MAC_5_00)) {
+		/* No VLAN ID filtering */
+		goto done;
+	}
+
+	ret = update_vlan_list(osi_core, l_core->ops_p, list);
+	if (ret < 0) {
+		goto done;
+	}
+
+	if (list->action == OSI_VLAN_ACTION_ADD) {
+		used = OSI_ENABLE;
+	}
+
+	for (i = 0U; i < list->count; i++) {
+		l_core->cfg.vlan[list->vid[i]].vid = list->vid[i];
+		l_core->cfg.vlan[list->vid[i]].used = used;
+	}
+	l_core->cfg.flags |= DYNAMIC_CFG_VLAN;
+
+done:
+	return ret;
+}
+
+/**
+ * @brief rss_pick_queues - Find busiest and least loaded RSS queues
+ *
+ * @note
+ * Algorithm:
+ *  - Among enabled MTL queues of the RSS set pick the most loaded one
+ *    which owns more than one bucket, and the least loaded one.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in] load: Load per queue.
+ * @param[in] nb: Number of RSS buckets per queue.
+ * @param[in] set: Bitmap of queues in the RSS set.
+ * @param[out] hot: Busiest queue.
+ * @param[out] cold: Least loaded queue.
+ */
+static void rss_pick_queues(const struct osi_core_priv_data *const osi_core,
+			    const nveu64_t *load, const nveu32_t *nb,
+			    nveu32_t set, nveu32_t *hot, nveu32_t *cold)
+{
+	nveu32_t i, q;
+
+	*hot = OSI_MGBE_MAX_NUM_QUEUES;
+	*cold = OSI_MGBE_MAX_NUM_QUEUES;
+	for (i = 0U; i < osi_core->num_mtl_queues; i++) {
+		q = osi_core->mtl_queues[i];
+		if ((q >= OSI_MGBE_MAX_NUM_QUEUES) ||
+		    ((set & OSI_BIT(q)) == 0U)) {
+			continue;
+		}
+
+		if ((nb[q] > 1U) &&
+		    ((*hot == OSI_MGBE_MAX_NUM_QUEUES) || (load[q] > load[*hot]))) {
+			*hot = q;
+		}
+
+		if ((*cold == OSI_MGBE_MAX_NUM_QUEUES) || (load[q] < load[*cold])) {
+			*cold = q;
+		}
+	}
+}
+
+/**
+ * @brief rss_rebalance - Rebalance RSS table on per queue load
+ *
+ * @note
+ * Algorithm:
+ *  - HW has no per bucket counters, so a queue load is taken as evenly
+ *    spread over its buckets.
+ *  - Buckets only move between enabled queues already in the RSS table,
+ *    the mean is taken over those queues.
+ *  - While the busiest queue exceeds the mean by more than
+ *    imbalance_pct and moving one of its buckets to the least loaded
+ *    queue lowers the peak, move the next bucket of the busy queue
+ *    found from a rotating cursor, so a hot bucket is isolated over
+ *    successive calls.
+ *  - Write only the changed RSS table entries.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in, out] rb: Rebalancing request, moved is updated.
+ *
+ * @retval 0 on success
+ * @retval -1 on failure.
+ */
+static nve32_t rss_rebalance(struct osi_core_priv_data *const osi_core,
+			     struct osi_rss_rebalance *const rb)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t old[OSI_RSS_MAX_TABLE_SIZE];
+	nveu64_t load[OSI_MGBE_MAX_NUM_QUEUES];
+	nveu32_t nb[OSI_MGBE_MAX_NUM_QUEUES];
+	nveu32_t max_moves = (rb->max_moves != 0U) ? rb->max_moves :
+			     OSI_RSS_REBAL_MOVES;
+	nveu64_t total = 0U, thr, share;
+	nveu32_t hot, cold, i, n, idx = 0U;
+	nveu32_t set = 0U, nq = 0U;
+	nve32_t ret = -1;
+
+	rb->moved = 0U;
+	if ((osi_core->rss.enable == OSI_DISABLE) ||
+	    (osi_core->num_mtl_queues < 2U) ||
+	    (osi_core->num_mtl_queues > OSI_MGBE_MAX_NUM_QUEUES) ||
+	    (rb->imbalance_pct > OSI_RSS_REBAL_MAX_PCT)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "RSS rebalance: invalid request\n",
+			     (nveul64_t)rb->imbalance_pct);
+		goto done;
+	}
+
+	osi_memset(nb, 0, sizeof(nb));
+	for (i = 0U; i < OSI_RSS_MAX_TABLE_SIZE; i++) {
+		if (osi_core->rss.table[i] >= OSI_MGBE_MAX_NUM_QUEUES) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "RSS rebalance: invalid table entry\n",
+				     (nveul64_t)i);
+			goto done;
+		}
+		nb[osi_core->rss.table[i]]++;
+		set |= OSI_BIT(osi_core->rss.table[i]);
+	}
+
+	for (i = 0U; i < osi_core->num_mtl_queues; i++) {
+		if ((osi_core->mtl_queues[i] < OSI_MGBE_MAX_NUM_QUEUES) &&
+		    ((set & OSI_BIT(osi_core->mtl_queues[i])) != 0U)) {
+			nq++;
+		}
+	}
+
+	(void)osi_memcpy(old, osi_core->rss.table, sizeof(old));
+	ret = 0;
+	if (nq < 2U) {
+		/* Nothing to balance between */
+		goto done;
+	}
+
+	for (i = 0U; i < OSI_MGBE_MAX_NUM_QUEUES; i++) {
+		load[i] = rb->q_rx_pkt[i];
+		if (((set & OSI_BIT(i)) != 0U) &&
+		    (total <= (~0ULL - load[i]))) {
+			total += load[i];
+		}
+	}
+	thr = total / nq;
+	if ((rb->imbalance_pct != 0U) &&
+	    (thr > (~0ULL / rb->imbalance_pct))) {
+		/* thr * pct would overflow, precision doesn't matter here */
+		share = (thr / 100U) * rb->imbalance_pct;
+	} else {
+		share = (thr * rb->imbalance_pct) / 100U;
+	}
+	thr = (thr <= (~0ULL - share)) ? (thr + share) : ~0ULL;
+
+	while (rb->moved < max_moves) {
+		rss_pick_queues(osi_core, load, nb, set, &hot, &cold);
+		if ((hot == OSI_MGBE_MAX_NUM_QUEUES) || (hot == cold) ||
+		    (load[hot] <= thr)) {
+			break;
+		}
+
+		share = load[hot] / nb[hot];
+		if ((load[cold] + share) >= load[hot]) {
+			/* Move would only shift the peak */
+			break;
+		}
+
+		for (n = 0U; n < OSI_RSS_MAX_TABLE_SIZE; n++) {
+			idx = (l_core->rss_cursor + n) % OSI_RSS_MAX_TABLE_SIZE;
+			if (osi_core->rss.table[idx] == hot) {
+				break;
+			}
+		}
+
+		osi_core->rss.table[idx] = cold;
+		l_core->rss_cursor = (idx + 1U) % OSI_RSS_MAX_TABLE_SIZE;
+		load[hot] -= share;
+		load[cold] += share;
+		nb[hot]--;
+		nb[cold]++;
+		rb->moved++;
+	}
+
+	if (rb->moved != 0U) {
+		ret = l_core->ops_p->update_rss_table(osi_core, old);
+		if (ret < 0) {
+			/* HW update failed, keep SW table in line with HW */
+			(void)osi_memcpy(osi_core->rss.table, old, sizeof(old));
+			rb->moved = 0U;
+		}
+	}
+
+done:
+	return ret;
+}
+
 /**
  * @brief conf_eee - Configure EEE LPI in MAC.
  *
@@ -1943,6 +2495,71 @@ fail:
 	return val;
 }
 
+/**
+ * @brief ptp_servo_reset - Reset M2M PTP servo state
+ *
+ * Algorithm:
+ * - Move servo back to SERVO_STATS_0 and clear drift and last ppb.
+ * - Clear locked sample count so that time to lock can be measured
+ *   from the reset.
+ *
+ * @param[in] l_core: Core local data of secondary interface
+ */
+static inline void ptp_servo_reset(struct core_local *const l_core)
+{
+	l_core->serv.count = SERVO_STATS_0;
+	l_core->serv.drift = 0;
+	l_core->serv.last_ppb = 0;
+#ifndef OSI_STRIPPED_LIB
+	l_core->osi_core.stats.m2m_servo_locked_samples = 0UL;
+#endif /* !OSI_STRIPPED_LIB */
+}
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @brief ptp_servo_update_stats - Update M2M PTP servo statistics
+ *
+ * Algorithm:
+ * - Count processed offset sample and store its absolute value.
+ * - If servo went back to SERVO_STATS_0 restart locked sample count,
+ *   count it as jump only if offset is beyond the 1 sec servo range.
+ *   Resets on out of order or overflowing samples are not jumps.
+ * - If servo is in SERVO_STATS_2 count it as locked sample.
+ *
+ * @param[in] sec_osi_core: secondary interface osi core pointer
+ * @param[in] offset: offset between primary and secondary interface
+ */
+static inline void ptp_servo_update_stats(struct osi_core_priv_data *sec_osi_core,
+					  nvel64_t offset)
+{
+	const struct core_local *l_core = (struct core_local *)(void *)sec_osi_core;
+	struct osi_stats *stats = &sec_osi_core->stats;
+
+	stats->m2m_servo_samples =
+		osi_update_stats_counter(stats->m2m_servo_samples, 1UL);
+	if (offset < 0) {
+		stats->m2m_servo_last_offset = 0ULL - (nveu64_t)offset;
+	} else {
+		stats->m2m_servo_last_offset = (nveu64_t)offset;
+	}
+
+	if (l_core->serv.count == SERVO_STATS_0) {
+		if (stats->m2m_servo_last_offset >= OSI_NSEC_PER_SEC) {
+			stats->m2m_servo_jumps =
+				osi_update_stats_counter(stats->m2m_servo_jumps,
+							 1UL);
+		}
+		stats->m2m_servo_locked_samples = 0UL;
+	} else if (l_core->serv.count == SERVO_STATS_2) {
+		stats->m2m_servo_locked_samples =
+			osi_update_stats_counter(stats->m2m_servo_locked_samples,
+						 1UL);
+	} else {
+		/* servo still collecting samples */
+	}
+}
+#endif /* !OSI_STRIPPED_LIB */
+
 /**
  * @brief calculate frequency adjustment between primary and secondary
  *  controller.
@@ -2084,6 +2701,9 @@ static inline nve32_t freq_offset_calculate(struct osi_core_priv_data *sec_osi_c
 	s->last_ppb = ppb;
 
 fail:
+#ifndef OSI_STRIPPED_LIB
+	ptp_servo_update_stats(sec_osi_core, offset);
+#endif /* !OSI_STRIPPED_LIB */
 	if ((ppb > INT_MAX) || (ppb < -INT_MAX)) {
 		ppb = 0LL;
 	}
@@ -2129,6 +2749,14 @@ static void cfg_l2_filter(struct core_local *l_core)
 		(void)osi_l2_filter((struct osi_core_priv_data *)(void *)l_core,
 				    &l_core->cfg.l2[i].filter);
 	}
+
+#ifndef OSI_STRIPPED_LIB
+	if (l_core->l2_hash_pfr != 0U) {
+		hw_config_l2_hash((struct osi_core_priv_data *)(void *)l_core,
+				  l_core->l2_hash, OSI_NULL,
+				  EQOS_MAX_HTR_REGS, l_core->l2_hash_pfr);
+	}
+#endif /* !OSI_STRIPPED_LIB */
 }
 
 static void cfg_rxcsum(struct core_local *l_core)
@@ -2140,15 +2768,32 @@ static void cfg_rxcsum(struct core_local *l_core)
 #ifndef OSI_STRIPPED_LIB
 static void cfg_vlan(struct core_local *l_core)
 {
+	struct osi_core_priv_data *osi_core = (struct osi_core_priv_data *)(void *)l_core;
+	nveu16_t vid[VLAN_RESTORE_BATCH];
+	struct osi_vlan_list list = { OSI_VLAN_ACTION_ADD, 0U, vid };
 	nveu32_t i;
 
+	if ((osi_core->mac_ver == OSI_EQOS_MAC_4_10) ||
+	    (osi_core->mac_ver == OSI_EQOS_MAC_5_00)) {
+		/* No VLAN ID filtering */
+		return;
+	}
+
 	for (i = 0U; i < VLAN_NUM_VID; i++) {
 		if (l_core->cfg.vlan[i].used == OSI_DISABLE) {
 			continue;
 		}
 
-		(void)vlan_id_update((struct osi_core_priv_data *)(void *)l_core,
-				     (l_core->cfg.vlan[i].vid | OSI_VLAN_ACTION_ADD));
+		vid[list.count] = (nveu16_t)l_core->cfg.vlan[i].vid;
+		list.count++;
+		if (list.count == VLAN_RESTORE_BATCH) {
+			(void)update_vlan_list(osi_core, l_core->ops_p, &list);
+			list.count = 0U;
+		}
+	}
+
+	if (list.count != 0U) {
+		(void)update_vlan_list(osi_core, l_core->ops_p, &list);
 	}
 }
 
@@ -2203,6 +2848,43 @@ static void cfg_ptp(struct core_local *l_core)
 	(void)osi_handle_ioctl(osi_core, &ioctl_data);
 }
 
+#ifndef OSI_STRIPPED_LIB
+static void cfg_pps(struct core_local *l_core)
+{
+	nveu32_t i;
+
+	for (i = 0U; i < OSI_MAX_PPS_OUT; i++) {
+		if (l_core->cfg.pps[i].enable == OSI_DISABLE) {
+			continue;
+		}
+
+		/* start time already passed, so output is rescheduled */
+		(void)hw_config_pps((struct osi_core_priv_data *)(void *)l_core,
+				    &l_core->cfg.pps[i]);
+	}
+}
+
+static void cfg_rxq_remap(struct core_local *l_core)
+{
+	nveu32_t i;
+
+	for (i = 0U; i < OSI_MGBE_MAX_NUM_QUEUES; i++) {
+		if ((l_core->cfg.rxq_remap_mask & OSI_BIT(i)) == OSI_NONE) {
+			continue;
+		}
+
+		(void)hw_remap_rxq((struct osi_core_priv_data *)(void *)l_core,
+				   &l_core->cfg.rxq_remap[i]);
+	}
+}
+
+static void cfg_pfc(struct core_local *l_core)
+{
+	(void)hw_config_pfc((struct osi_core_priv_data *)(void *)l_core,
+			    &l_core->cfg.pfc);
+}
+#endif /* !OSI_STRIPPED_LIB */
+
 static void cfg_frp(struct core_local *l_core)
 {
 	struct osi_core_priv_data *osi_core = (struct osi_core_priv_data *)(void *)l_core;
@@ -2214,7 +2896,7 @@ static void apply_dynamic_cfg(struct osi_core_priv_data *osi_core)
 {
 	struct core_local *l_core = (struct core_local *)(void *)osi_core;
 	typedef void (*cfg_fn)(struct core_local *local_core);
-	const cfg_fn fn[11] = {
+	const cfg_fn fn[14] = {
 		[DYNAMIC_CFG_L3_L4_IDX] = cfg_l3_l4_filter,
 		[DYNAMIC_CFG_L2_IDX] = cfg_l2_filter,
 		[DYNAMIC_CFG_RXCSUM_IDX] = cfg_rxcsum,
@@ -2227,7 +2909,12 @@ static void apply_dynamic_cfg(struct osi_core_priv_data *osi_core)
 		[DYNAMIC_CFG_EST_IDX] = cfg_est,
 		[DYNAMIC_CFG_FPE_IDX] = cfg_fpe,
 		[DYNAMIC_CFG_PTP_IDX] = cfg_ptp,
-		[DYNAMIC_CFG_FRP_IDX] = cfg_frp
+		[DYNAMIC_CFG_FRP_IDX] = cfg_frp,
+#ifndef OSI_STRIPPED_LIB
+		[DYNAMIC_CFG_PPS_IDX] = cfg_pps,
+		[DYNAMIC_CFG_RXQ_REMAP_IDX] = cfg_rxq_remap,
+		[DYNAMIC_CFG_PFC_IDX] = cfg_pfc
+#endif /* !OSI_STRIPPED_LIB */
 	};
 	nveu32_t flags = l_core->cfg.flags;
 	nveu32_t i = 0U;
@@ -2675,9 +3362,7 @@ static nve32_t osi_hal_handle_ioctl(struct osi_core_priv_data *osi_core,
 							&secondary_time);
 			ret = osi_adjust_time(sec_osi_core, drift_value);
 			if (ret == 0) {
-				secondary_osi_lcore->serv.count = SERVO_STATS_0;
-				secondary_osi_lcore->serv.drift = 0;
-				secondary_osi_lcore->serv.last_ppb = 0;
+				ptp_servo_reset(secondary_osi_lcore);
 				ret = osi_adjust_freq(sec_osi_core, 0);
 			}
 		}
@@ -2719,9 +3404,7 @@ static nve32_t osi_hal_handle_ioctl(struct osi_core_priv_data *osi_core,
 
 		if ((l_core->ether_m2m_role == OSI_PTP_M2M_PRIMARY) &&
 		    (data->arg1_u32 == OSI_ENABLE)) {
-			secondary_osi_lcore->serv.count = SERVO_STATS_0;
-			secondary_osi_lcore->serv.drift = 0;
-			secondary_osi_lcore->serv.last_ppb = 0;
+			ptp_servo_reset(secondary_osi_lcore);
 		}
 
 		break;
@@ -2759,9 +3442,7 @@ static nve32_t osi_hal_handle_ioctl(struct osi_core_priv_data *osi_core,
 			osi_unlock_irq_enabled(&secondary_osi_lcore->serv.m2m_lock);
 			ret = hw_set_systime_to_mac(sec_osi_core, sec, nsec);
 			if (ret == 0) {
-				secondary_osi_lcore->serv.count = SERVO_STATS_0;
-				secondary_osi_lcore->serv.drift = 0;
-				secondary_osi_lcore->serv.last_ppb = 0;
+				ptp_servo_reset(secondary_osi_lcore);
 				ret = osi_adjust_freq(sec_osi_core, 0);
 			}
 		}
@@ -2786,6 +3467,124 @@ static nve32_t osi_hal_handle_ioctl(struct osi_core_priv_data *osi_core,
 		ret = ops_p->config_rss(osi_core);
 		break;
 
+	case OSI_CMD_RSS_REBALANCE:
+		ret = rss_rebalance(osi_core, &data->rss_rebal);
+		break;
+
+	case OSI_CMD_RSS_HASH:
+		ret = rss_hash_calc(osi_core, &data->rss_hash);
+		break;
+
+	case OSI_CMD_RSS_UPDATE:
+		if ((osi_core->rss.enable == OSI_DISABLE) ||
+		    (data->arg1_u32 == OSI_NONE) ||
+		    ((data->arg1_u32 & ~OSI_RSS_UPD_MASK) != OSI_NONE) ||
+		    ((osi_core->rss.hash_fields & ~OSI_RSS_HASH_DEFAULT) != OSI_NONE)) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				     "Invalid RSS update\n",
+				     (nveul64_t)data->arg1_u32);
+			break;
+		}
+
+		ret = ops_p->update_rss(osi_core, data->arg1_u32);
+		break;
+
+	case OSI_CMD_CONFIG_PPS:
+		ret = hw_config_pps(osi_core, &data->pps_config);
+		if (ret == 0) {
+			(void)osi_memcpy(&l_core->cfg.pps[data->pps_config.idx],
+					 &data->pps_config,
+					 sizeof(struct osi_pps_config));
+			l_core->cfg.flags |= DYNAMIC_CFG_PPS;
+		}
+		break;
+
+	case OSI_CMD_RXQ_REMAP:
+		ret = hw_remap_rxq(osi_core, &data->rxq_remap);
+		if (ret == 0) {
+			(void)osi_memcpy(&l_core->cfg.rxq_remap[data->rxq_remap.rxq],
+					 &data->rxq_remap,
+					 sizeof(struct osi_rxq_remap));
+			l_core->cfg.rxq_remap_mask |= OSI_BIT(data->rxq_remap.rxq);
+			l_core->cfg.flags |= DYNAMIC_CFG_RXQ_REMAP;
+			/* PFC pause generation follows the RX queue priorities */
+			if (((l_core->cfg.flags & DYNAMIC_CFG_PFC) != OSI_NONE) &&
+			    (hw_config_pfc(osi_core, &l_core->cfg.pfc) < 0)) {
+				/* Remap is in place, PFC keeps the old queues */
+				OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+					     "PFC update after RX queue remap failed\n",
+					     (nveul64_t)data->rxq_remap.rxq);
+			}
+		}
+		break;
+
+	case OSI_CMD_EST_PLAN:
+		ret = est_plan(osi_core, &data->est_plan, &data->est);
+		if ((ret < 0) || (data->est_plan.apply != OSI_ENABLE)) {
+			break;
+		}
+
+		ret = config_est(osi_core, &data->est);
+		if (ret == 0) {
+			(void)osi_memcpy(&l_core->cfg.est, &data->est,
+					 sizeof(struct osi_est_config));
+			l_core->cfg.flags |= DYNAMIC_CFG_EST;
+		}
+		break;
+
+	case OSI_CMD_READ_STATS:
+		ops_p->read_mmc(osi_core);
+		hw_fpe_stats(osi_core);
+		hw_pfc_stats(osi_core);
+		ret = 0;
+		break;
+
+	case OSI_CMD_CONFIG_CBS:
+		ret = config_cbs(osi_core, &data->cbs);
+		break;
+
+	case OSI_CMD_CONFIG_PFC:
+		ret = hw_config_pfc(osi_core, &data->pfc);
+		if (ret == 0) {
+			(void)osi_memcpy(&l_core->cfg.pfc, &data->pfc,
+					 sizeof(struct osi_pfc_config));
+			l_core->cfg.flags |= DYNAMIC_CFG_PFC;
+		}
+		break;
+
+	case OSI_CMD_EST_WAIT_SWAP:
+		ret = hw_est_wait_swap(osi_core, data->arg1_u32);
+		break;
+
+	case OSI_CMD_FRP_EVAL:
+		ret = frp_eval(osi_core, &data->frp_eval);
+		break;
+
+	case OSI_CMD_FLOW_STEER:
+		if ((osi_core->mac == OSI_MAC_HW_EQOS) &&
+		    (osi_core->mac_ver < OSI_EQOS_MAC_5_30)) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_HW_FAIL,
+				     "MAC doesn't support FRP\n", OSI_NONE);
+			break;
+		}
+
+		ret = setup_flow(osi_core, l_core->ops_p, &data->flow_spec);
+		if ((ret == 0) && (data->flow_spec.cmd != OSI_FLOW_CMD_GET)) {
+			l_core->cfg.flags |= DYNAMIC_CFG_FRP;
+		}
+		break;
+
+	case OSI_CMD_L2_ADDR_LIST:
+		ret = osi_l2_addr_list(osi_core, &data->l2_addr_list);
+		if (ret == 0) {
+			l_core->cfg.flags |= DYNAMIC_CFG_L2;
+		}
+		break;
+
+	case OSI_CMD_VLAN_LIST:
+		ret = vlan_list_update(osi_core, &data->vlan_list);
+		break;
+
 #endif /* !OSI_STRIPPED_LIB */
 	case OSI_CMD_CONFIG_FRP:
 		ret = configure_frp(osi_core, &data->frp_cmd);
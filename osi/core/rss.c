@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef OSI_STRIPPED_LIB
+#include "../osi/common/common.h"
+#include "rss.h"
+
+/**
+ * @brief rss_key_window - Get 32 bit key window at a bit offset.
+ *
+ * Algorithm: Key is a big endian bit stream, return bits
+ *	[bit, bit + 31] of it.
+ *
+ * @param[in] key: RSS hash key.
+ * @param[in] bit: Bit offset, bit + 32 must be within the key.
+ *
+ * @retval 32 bit key window
+ */
+static nveu32_t rss_key_window(const nveu8_t *key, nveu32_t bit)
+{
+	nveu32_t byte = bit >> 3U;
+	nveu32_t shift = bit & 0x7U;
+	nveu32_t win;
+
+	win = ((nveu32_t)key[byte] << 24U) |
+	      ((nveu32_t)key[byte + 1U] << 16U) |
+	      ((nveu32_t)key[byte + 2U] << 8U) |
+	      (nveu32_t)key[byte + 3U];
+	if (shift != 0U) {
+		win = (win << shift) |
+		      ((nveu32_t)key[byte + 4U] >> (8U - shift));
+	}
+
+	return win;
+}
+
+/**
+ * @brief rss_lut_build - Build Toeplitz lookup tables for current key.
+ *
+ * Algorithm: For every input nibble position and nibble value store the
+ *	XOR of the key windows selected by the set bits, so hashing takes
+ *	two lookups per input byte. Tables are rebuilt only when the key
+ *	changes.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ */
+static void rss_lut_build(struct osi_core_priv_data *const osi_core)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t win[4];
+	nveu32_t n, v, b, h;
+
+	if ((l_core->rss_lut_valid == OSI_ENABLE) &&
+	    (osi_memcmp(l_core->rss_lut_key, osi_core->rss.key,
+			(nve32_t)OSI_RSS_HASH_KEY_SIZE) == 0)) {
+		return;
+	}
+
+	for (n = 0U; n < RSS_LUT_NIBBLES; n++) {
+		for (b = 0U; b < 4U; b++) {
+			win[b] = rss_key_window(osi_core->rss.key, (n * 4U) + b);
+		}
+
+		for (v = 0U; v < 16U; v++) {
+			h = 0U;
+			for (b = 0U; b < 4U; b++) {
+				/* MSB of the nibble is the first input bit */
+				if ((v & OSI_BIT(3U - b)) != 0U) {
+					h ^= win[b];
+				}
+			}
+			l_core->rss_lut[n][v] = h;
+		}
+	}
+
+	(void)osi_memcpy(l_core->rss_lut_key, osi_core->rss.key,
+			 OSI_RSS_HASH_KEY_SIZE);
+	l_core->rss_lut_valid = OSI_ENABLE;
+}
+
+/**
+ * @brief rss_toeplitz - Toeplitz hash of input using lookup tables.
+ *
+ * @param[in] l_core: OSI core local data structure.
+ * @param[in] in: Hash input.
+ * @param[in] len: Input length, max RSS_HASH_IN_MAX.
+ *
+ * @retval hash value
+ */
+static nveu32_t rss_toeplitz(const struct core_local *const l_core,
+			     const nveu8_t *in, nveu32_t len)
+{
+	nveu32_t hash = 0U;
+	nveu32_t i;
+
+	for (i = 0U; i < len; i++) {
+		hash ^= l_core->rss_lut[i * 2U][in[i] >> 4U];
+		hash ^= l_core->rss_lut[(i * 2U) + 1U][in[i] & 0xFU];
+	}
+
+	return hash;
+}
+
+nve32_t rss_hash_calc(struct osi_core_priv_data *const osi_core,
+		      struct osi_rss_hash *const req)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu8_t in[RSS_HASH_IN_MAX];
+	nveu32_t fields = osi_core->rss.hash_fields;
+	nveu32_t alen, len;
+	nve32_t ret = -1;
+
+	if (req->ip_ver == OSI_RSS_IPV4) {
+		alen = RSS_IP4_ADDR_LEN;
+	} else if (req->ip_ver == OSI_RSS_IPV6) {
+		alen = RSS_IP6_ADDR_LEN;
+	} else {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "RSS hash: invalid IP version\n",
+			     (nveul64_t)req->ip_ver);
+		goto done;
+	}
+
+	rss_lut_build(osi_core);
+
+	/* Source address, destination address, source and destination
+	 * port, all in network byte order
+	 */
+	(void)osi_memcpy(in, req->src_ip, alen);
+	(void)osi_memcpy(&in[alen], req->dst_ip, alen);
+	len = alen * 2U;
+
+	if (fields == OSI_NONE) {
+		fields = OSI_RSS_HASH_DEFAULT;
+	}
+
+	req->hashed = OSI_DISABLE;
+	req->l4 = OSI_DISABLE;
+	if (((req->l4_proto == OSI_RSS_L4_TCP) &&
+	     ((fields & OSI_RSS_HASH_TCP) != OSI_NONE)) ||
+	    ((req->l4_proto == OSI_RSS_L4_UDP) &&
+	     ((fields & OSI_RSS_HASH_UDP) != OSI_NONE))) {
+		in[len] = (nveu8_t)(req->src_port >> 8U);
+		in[len + 1U] = (nveu8_t)(req->src_port & 0xFFU);
+		in[len + 2U] = (nveu8_t)(req->dst_port >> 8U);
+		in[len + 3U] = (nveu8_t)(req->dst_port & 0xFFU);
+		len += (RSS_L4_PORT_LEN * 2U);
+		req->l4 = OSI_ENABLE;
+	} else if ((fields & OSI_RSS_HASH_IP) == OSI_NONE) {
+		/* Not hashed, HW uses the default queue */
+		req->hash = 0U;
+		req->index = 0U;
+		req->queue = 0U;
+		ret = 0;
+		goto done;
+	} else {
+		/* L3 2-tuple */
+	}
+
+	req->hashed = OSI_ENABLE;
+	req->hash = rss_toeplitz(l_core, in, len);
+	req->index = req->hash & (OSI_RSS_MAX_TABLE_SIZE - 1U);
+	req->queue = osi_core->rss.table[req->index];
+	ret = 0;
+
+done:
+	return ret;
+}
+#endif /* !OSI_STRIPPED_LIB */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef RSS_H
+#define RSS_H
+
+#include <osi_common.h>
+#include <osi_core.h>
+#include "core_local.h"
+
+#ifndef OSI_STRIPPED_LIB
+/**
+ * @addtogroup RSS-HASH SW RSS hash defines
+ *
+ * @brief Toeplitz input field lengths
+ * @{
+ */
+#define RSS_IP4_ADDR_LEN	4U
+#define RSS_IP6_ADDR_LEN	16U
+#define RSS_L4_PORT_LEN		2U
+/** @} */
+
+/**
+ * @brief rss_hash_calc - Compute RSS hash and queue of a flow in SW.
+ *
+ * Algorithm: Build the Toeplitz input from the flow tuple as selected by
+ *	rss.hash_fields, hash it with per key nibble lookup tables and map
+ *	the hash through the RSS indirection table. No HW access.
+ *
+ * @param[in] osi_core: OSI core private data structure.
+ * @param[in, out] req: Flow tuple, hash, index and queue are filled.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+nve32_t rss_hash_calc(struct osi_core_priv_data *const osi_core,
+		      struct osi_rss_hash *const req);
+#endif /* !OSI_STRIPPED_LIB */
+#endif /* RSS_H */
@@ -25,146 +25,154 @@
 #include "vlan_filter.h"
 
 /**
- * @brief get_vlan_filter_idx - Get VLAN HW filter index which match vlan_id
+ * @brief vlan_hash_bucket - Get VLAN hash filter bucket of a VID
  *
- * Algorithm: From VID flags gets the set bit position and get the value
- * from that position and compare with vlan ID passed to this function
+ * Algorithm: CRC-32 (reflected, poly 0xEDB88320) over the 12 bit VID,
+ * bucket is the bit reversed low nibble of the inverted CRC, same as HW
+ * with 12 bit VLAN tag comparison.
  *
- * @param[in] osi_core: OSI core private data
- * @param[in] vlan_id: VLAN ID to be searched in HW filters
+ * @param[in] vlan_id: VLAN ID
  *
- * @return Index from VID array if match found.
- * @return Return VLAN_HW_FILTER_FULL_IDX if not found.
+ * @return hash bucket index
  */
-static inline nveu32_t get_vlan_filter_idx(
-					struct osi_core_priv_data *osi_core,
-					nveu16_t vlan_id)
+static inline nveu32_t vlan_hash_bucket(nveu16_t vlan_id)
 {
-	nveu32_t vid_idx = VLAN_HW_FILTER_FULL_IDX;
-	unsigned long bitmap = osi_core->vf_bitmap;
-	unsigned long temp = 0U;
-
-	while (bitmap != 0U) {
-		temp = (unsigned long) __builtin_ctzl(bitmap);
+	nveu32_t crc = 0xFFFFFFFFU;
+	nveu32_t data = vlan_id;
+	nveu32_t bucket = 0U;
+	nveu32_t i;
 
-		if (osi_core->vid[temp] == vlan_id) {
-			/* vlan ID match found */
-			vid_idx = (nveu32_t)temp;
-			break;
+	for (i = 0U; i < VLAN_VID_BITS; i++) {
+		if (((crc ^ data) & OSI_BIT(0)) != 0U) {
+			crc = (crc >> 1U) ^ 0xEDB88320U;
+		} else {
+			crc >>= 1U;
 		}
+		data >>= 1U;
+	}
 
-		bitmap &= ~OSI_BIT(temp);
+	crc = ~crc;
+	for (i = 0U; i < 4U; i++) {
+		bucket = (bucket << 1U) | ((crc >> i) & OSI_BIT(0));
 	}
 
-	return vid_idx;
+	return bucket;
 }
 
 /**
- * @brief allow_all_vid_tags - Program MAC to pass all VID
- *
- * Algorithm: Enable HASH filtering and program the hash to 0xFFFF
- * if all VID's to pass. For not to pass all VID's disable HASH
- * filtering and program the HASH as zero.
+ * @brief vlan_bit_test - Check VID membership in a VLAN bitmap
  *
- * @param[in] base: MAC base address
- * @param[in] pass_all_vids: Flag to pass all VID's or not.
+ * @param[in] map: VLAN bitmap of VLAN_SET_WORDS words
+ * @param[in] vlan_id: VLAN ID
  *
- * @return 0 on success
+ * @return OSI_ENABLE if set, OSI_DISABLE otherwise
  */
-static inline nve32_t allow_all_vid_tags(nveu8_t *base,
-				     nveu32_t pass_all_vids)
+static inline nveu32_t vlan_bit_test(const nveu32_t *map, nveu16_t vlan_id)
 {
-	nveu32_t vlan_tag_reg = 0;
-	nveu32_t hash_filter_reg = 0;
+	return ((map[vlan_id >> 5U] & OSI_BIT(vlan_id & 0x1FU)) != 0U) ?
+		OSI_ENABLE : OSI_DISABLE;
+}
 
-	vlan_tag_reg = osi_readl(base + MAC_VLAN_TAG_CTRL);
-	hash_filter_reg = osi_readl(base + MAC_VLAN_HASH_FILTER);
+/**
+ * @brief vlan_lowest_bit - Index of the lowest set bit
+ *
+ * @param[in] map: Non zero bitmap
+ *
+ * @return bit index
+ */
+static inline nveu32_t vlan_lowest_bit(nveu64_t map)
+{
+	nveu32_t idx = 0U;
 
-	if (pass_all_vids == OSI_ENABLE) {
-		vlan_tag_reg |= MAC_VLAN_TAG_CTRL_VHTM;
-		hash_filter_reg |= VLAN_HASH_ALLOW_ALL;
-	} else {
-		vlan_tag_reg &= ~MAC_VLAN_TAG_CTRL_VHTM;
-		hash_filter_reg &= (nveu32_t) ~VLAN_HASH_ALLOW_ALL;
+	while ((idx < 63U) && (((map >> idx) & 1ULL) == 0ULL)) {
+		idx++;
 	}
 
-	osi_writel(vlan_tag_reg, base + MAC_VLAN_TAG_CTRL);
-	osi_writel(hash_filter_reg, base + MAC_VLAN_HASH_FILTER);
+	return idx;
+}
 
-	return 0;
+/**
+ * @brief vlan_hash_supported - Check VLAN hash filter support
+ *
+ * @param[in] osi_core: OSI core private data
+ *
+ * @return OSI_ENABLE if HW has VLAN hash filter, OSI_DISABLE otherwise
+ */
+static inline nveu32_t vlan_hash_supported(
+				const struct osi_core_priv_data *osi_core)
+{
+	return ((osi_core->hw_feature != OSI_NULL) &&
+		(osi_core->hw_feature->vlan_hash_en == OSI_ENABLE)) ?
+		OSI_ENABLE : OSI_DISABLE;
 }
 
 /**
- * @brief is_vlan_id_enqueued - Checks passed VID already queued or not.
+ * @brief vlan_set_update - Add/Delete VID in SW VLAN set
  *
- * Algorithm: Search VID array from index VLAN_HW_FILTER_FULL_IDX
- * to total VID programmed count. If match found return index to VID
- * array or return negative value if no match.
+ * Algorithm: Update set bitmap, count and hash bucket counters. No HW
+ * access.
  *
- * @param[in] osi_core: OSI core private data
- * @param[in] vlan_id: VLAN ID to be searched in VID array.
- * @param[out] idx: Index of the VID array after match
+ * @param[in] l_core: OSI core local data
+ * @param[in] vlan_id: VLAN ID
+ * @param[in] add: OSI_ENABLE to add, OSI_DISABLE to delete
  *
- * @return 0 on Success.
- * @return negative value on failure
+ * @return 0 on success
+ * @return -1 if VID already added or not found.
  */
-static inline nve32_t is_vlan_id_enqueued(struct osi_core_priv_data *osi_core,
-				      nveu16_t vlan_id,
-				      nveu32_t *idx)
+static nve32_t vlan_set_update(struct core_local *l_core, nveu16_t vlan_id,
+			       nveu32_t add)
 {
-	nveu32_t i = 0;
+	struct osi_core_priv_data *osi_core = &l_core->osi_core;
+	nveu32_t bucket = vlan_hash_bucket(vlan_id);
+	nveu32_t bit = OSI_BIT(vlan_id & 0x1FU);
+	nve32_t ret = -1;
 
-	if (osi_core->vlan_filter_cnt == VLAN_HW_FILTER_FULL_IDX) {
-		/* No elements in SW queue to search */
-		return -1;
+	if (vlan_bit_test(l_core->vlan_set, vlan_id) == add) {
+		goto done;
 	}
 
-	for (i = VLAN_HW_FILTER_FULL_IDX; i <= osi_core->vlan_filter_cnt; i++) {
-		if (osi_core->vid[i] == vlan_id) {
-			*idx = i;
-			/* match found */
-			return 0;
-		}
+	if (add == OSI_ENABLE) {
+		l_core->vlan_set[vlan_id >> 5U] |= bit;
+		l_core->vlan_hash_cnt[bucket]++;
+		osi_core->vlan_filter_cnt++;
+	} else {
+		l_core->vlan_set[vlan_id >> 5U] &= ~bit;
+		l_core->vlan_hash_cnt[bucket]--;
+		osi_core->vlan_filter_cnt--;
 	}
+	ret = 0;
 
-	return -1;
+done:
+	return ret;
 }
 
 /**
- * @brief enqueue_vlan_id - ADD vlan_id to VID array.
+ * @brief vlan_next_overflow - Get a VID which is in set but not in HW
  *
- * Algorithm: Add VLAN ID to VID array at filter_cnt index.
+ * Algorithm: Scan set & ~hw bitmaps from word index *pos.
  *
- * @param[in] osi_core: OSI core private data
- * @param[in] vlan_id: VLAN ID to be added to VID array.
+ * @param[in] l_core: OSI core local data
+ * @param[in, out] pos: Word index to start from, updated
  *
- * @return 0 on success.
- * @return negative value on failure.
+ * @return VLAN ID, VLAN_ID_INVALID if none
  */
-static inline nve32_t enqueue_vlan_id(struct osi_core_priv_data *osi_core,
-				  nveu16_t vlan_id)
+static nveu16_t vlan_next_overflow(const struct core_local *l_core,
+				   nveu32_t *pos)
 {
-	nve32_t ret = 0;
-	nveu32_t idx;
-
-	if (osi_core->vlan_filter_cnt == VLAN_NUM_VID) {
-		/* Entire SW queue full */
-		return -1;
-	}
-
-	/* Check if requested vlan_id alredy queued */
-	ret = is_vlan_id_enqueued(osi_core, vlan_id, &idx);
-	if (ret == 0) {
-		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-			"VLAN ID already programmed\n",
-			0ULL);
-		return -1;
+	nveu16_t vlan_id = VLAN_ID_INVALID;
+	nveu32_t word;
+
+	while (*pos < VLAN_SET_WORDS) {
+		word = l_core->vlan_set[*pos] & ~l_core->vlan_hw[*pos];
+		if (word != 0U) {
+			vlan_id = (nveu16_t)((*pos << 5U) +
+					     vlan_lowest_bit(word));
+			break;
+		}
+		(*pos)++;
 	}
 
-	osi_core->vid[osi_core->vlan_filter_cnt] = vlan_id;
-	osi_core->vlan_filter_cnt++;
-
-	return 0;
+	return vlan_id;
 }
 
 /**
@@ -250,230 +258,264 @@ static inline nve32_t update_vlan_filters(struct osi_core_priv_data *osi_core,
 }
 
 /**
- * @brief add_vlan_id - Add VLAN ID.
+ * @brief config_vlan_hash - Program VLAN hash filter
  *
- * Algorithm: ADD VLAN ID to HW filters and SW VID array.
+ * Algorithm: With VIDs which don't fit in HW filters enable hash
+ * filtering with a bucket set for every VID in the set, disable it
+ * otherwise. Registers are written only when their value changes.
+ * Callers make sure there is no overflow without HW hash filter.
  *
- * @param[in] osi_core: OSI core private data.
- * @param[in] val: VLAN ID to be programmed.
- *
- * @return 0 on success
- * @return -1 on failure.
+ * @param[in] l_core: OSI core local data
+ * @param[in] overflow: Number of VIDs not in HW filters
  */
-static inline nve32_t add_vlan_id(struct osi_core_priv_data *osi_core,
-			      struct core_ops *ops_p,
-			      nveu16_t vlan_id)
+static void config_vlan_hash(struct core_local *l_core, nveu32_t overflow)
 {
-	nveu32_t vid_idx = 0;
-	nveu32_t val = 0;
-	nve32_t ret = 0;
+	nveu8_t *base = (nveu8_t *)l_core->osi_core.base;
+	nveu32_t vlan_tag_reg, tag;
+	nveu32_t hash_filter_reg, hash = 0U;
+	nveu32_t i;
 
-	/* Check if VLAN ID already programmed */
-	vid_idx = get_vlan_filter_idx(osi_core, vlan_id);
-	if (vid_idx != VLAN_HW_FILTER_FULL_IDX) {
-		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-			"VLAN ID already added\n",
-			0ULL);
-		return -1;
+	tag = osi_readl(base + MAC_VLAN_TAG_CTRL);
+	vlan_tag_reg = tag & ~(MAC_VLAN_TAG_CTRL_VHTM | MAC_VLAN_TAG_CTRL_ETV |
+			       MAC_VLAN_TAG_CTRL_OB);
+	if (overflow != 0U) {
+		for (i = 0U; i < VLAN_HASH_BUCKETS; i++) {
+			if (l_core->vlan_hash_cnt[i] != 0U) {
+				hash |= OSI_BIT(i);
+			}
+		}
+		vlan_tag_reg |= (MAC_VLAN_TAG_CTRL_VHTM | MAC_VLAN_TAG_CTRL_ETV);
 	}
 
-	/* Get free index to add the VID */
-	vid_idx = (nveu32_t) __builtin_ctzl(~osi_core->vf_bitmap);
-	/* If there is no free filter index add into SW VLAN filter queue to store */
-	if (vid_idx == VLAN_HW_FILTER_FULL_IDX) {
-		/* Add VLAN ID to SW queue */
-		ret = enqueue_vlan_id(osi_core, vlan_id);
-		if (ret < 0)
-			return ret;
-
-		/* Since VLAN HW filters full - program to allow all packets */
-		return allow_all_vid_tags(osi_core->base, OSI_ENABLE);
+	hash_filter_reg = osi_readl(base + MAC_VLAN_HASH_FILTER);
+	if ((hash_filter_reg & VLAN_HASH_ALLOW_ALL) != hash) {
+		hash_filter_reg &= (nveu32_t) ~VLAN_HASH_ALLOW_ALL;
+		hash_filter_reg |= hash;
+		osi_writel(hash_filter_reg, base + MAC_VLAN_HASH_FILTER);
 	}
 
-	osi_core->vf_bitmap |= OSI_BIT(vid_idx);
-	osi_core->vid[vid_idx] = vlan_id;
-	osi_core->vlan_filter_cnt++;
-
-	if (osi_core->vlan_filter_cnt > 0U) {
-		ret = ops_p->config_vlan_filtering(osi_core,
-						   OSI_ENABLE,
-						   OSI_DISABLE,
-						   OSI_DISABLE);
-		if (ret < 0) {
-			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				"Failed to enable VLAN filtering\n", 0ULL);
-			return -1;
-		}
+	if ((tag & ~MAC_VLAN_TAG_CTRL_OB) != vlan_tag_reg) {
+		osi_writel(vlan_tag_reg, base + MAC_VLAN_TAG_CTRL);
 	}
-
-	val = osi_readl((nveu8_t *)osi_core->base + MAC_VLAN_TAG_DATA);
-	val &= (nveu32_t) ~VLAN_VID_MASK;
-	val |= (vlan_id | MAC_VLAN_TAG_DATA_ETV | MAC_VLAN_TAG_DATA_VEN);
-
-	return update_vlan_filters(osi_core, vid_idx, val);
 }
 
 /**
- * @brief dequeue_vlan_id - Remove VLAN ID from VID array
+ * @brief sync_vlan_filters - Bring HW VLAN filters in line with VLAN set
  *
- * Algorithm: Do the left shift of array from index to
- * total filter count. Allow all VID tags after removal
- * VID if numbers of filter count is 32.
+ * Algorithm:
+ * - Release HW filters whose VID left the set.
+ * - Fill free HW filters with VIDs from the set which are not in HW.
+ * - Write only HW filters which changed, filters a previous sync failed
+ *   to write are written again.
+ * - Enable/disable VLAN filtering on set empty transitions.
+ * - Program hash filter for VIDs which don't fit in HW filters.
  *
- * @param[in]: osi_core: OSI core private data.
- * @param[in] idx: Index at which VLAN ID to be deleted.
+ * @param[in] osi_core: OSI core private data.
+ * @param[in] ops_p: Core operations.
+ * @param[in] old_cnt: Set size before the update.
  *
  * @return 0 on success
- * @return -1 on failure.
+ * @return -1 on failure, filters not written are kept for the next sync.
  */
-static inline nve32_t dequeue_vlan_id(struct osi_core_priv_data *osi_core,
-				  nveu32_t idx)
+static nve32_t sync_vlan_filters(struct osi_core_priv_data *osi_core,
+				 struct core_ops *ops_p, nveu32_t old_cnt)
 {
-	nveu32_t i;
-
-	if (osi_core->vlan_filter_cnt == VLAN_HW_MAX_NRVF) {
-		return -1;
-	}
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu64_t dirty = l_core->vlan_dirty;
+	nveu64_t bitmap = osi_core->vf_bitmap;
+	nveu32_t hw_cnt = 0U;
+	nveu32_t pos = 0U;
+	nveu32_t idx, val;
+	nveu16_t vlan_id;
+	nve32_t ret = 0;
 
-	/* Left shift the array elements by one for the VID order */
-	for (i = idx; i <= osi_core->vlan_filter_cnt; i++) {
-		osi_core->vid[i] = osi_core->vid[i + 1U];
-	}
+	while (bitmap != 0U) {
+		idx = vlan_lowest_bit(bitmap);
+		bitmap &= ~OSI_BIT(idx);
 
-	osi_core->vid[i] = VLAN_ID_INVALID;
-	osi_core->vlan_filter_cnt--;
+		vlan_id = osi_core->vid[idx];
+		if (vlan_bit_test(l_core->vlan_set, vlan_id) == OSI_ENABLE) {
+			hw_cnt++;
+			continue;
+		}
 
-	if (osi_core->vlan_filter_cnt == VLAN_HW_MAX_NRVF) {
-		return allow_all_vid_tags(osi_core->base, OSI_DISABLE);
+		l_core->vlan_hw[vlan_id >> 5U] &= ~OSI_BIT(vlan_id & 0x1FU);
+		osi_core->vf_bitmap &= ~OSI_BIT(idx);
+		osi_core->vid[idx] = VLAN_ID_INVALID;
+		dirty |= OSI_BIT(idx);
 	}
 
-	return 0;
-}
+	for (idx = 0U; (idx < VLAN_HW_MAX_NRVF) &&
+	     (hw_cnt < osi_core->vlan_filter_cnt); idx++) {
+		if ((osi_core->vf_bitmap & OSI_BIT(idx)) != 0U) {
+			continue;
+		}
 
-/**
- * @brief dequeue_vid_to_add_filter_reg - Get VID from Array and add to HW
- * filters.
- *
- * Algorithm: Get the VID from index 32 and program in HW filter
- * registers. With this first added VID will be programmed in filter registers
- * if any VID deleted from HW filter registers.
- *
- * @param[in]: osi_core: OSI core private data.
- * @param[in] idx: Index at which VLAN ID to be deleted.
- *
- * @return 0 on success
- * @return -1 on failure.
- */
-static inline nve32_t dequeue_vid_to_add_filter_reg(
-					struct osi_core_priv_data *osi_core,
-					nveu32_t vid_idx)
-{
-	nveu32_t val = 0;
-	nveu16_t vlan_id = 0;
-	nveu32_t i = 0;
-	nve32_t ret = 0;
+		vlan_id = vlan_next_overflow(l_core, &pos);
+		if (vlan_id == VLAN_ID_INVALID) {
+			break;
+		}
 
-	vlan_id = osi_core->vid[VLAN_HW_FILTER_FULL_IDX];
-	if (vlan_id == VLAN_ID_INVALID) {
-		return 0;
+		l_core->vlan_hw[vlan_id >> 5U] |= OSI_BIT(vlan_id & 0x1FU);
+		osi_core->vf_bitmap |= OSI_BIT(idx);
+		osi_core->vid[idx] = vlan_id;
+		dirty |= OSI_BIT(idx);
+		hw_cnt++;
+	}
+
+	if ((old_cnt == 0U) && (osi_core->vlan_filter_cnt > 0U)) {
+		ret = ops_p->config_vlan_filtering(osi_core, OSI_ENABLE,
+						   OSI_DISABLE, OSI_DISABLE);
+		if (ret < 0) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				"Failed to enable VLAN filtering\n", 0ULL);
+			goto done;
+		}
 	}
 
-	osi_core->vf_bitmap |= OSI_BIT(vid_idx);
-	osi_core->vid[vid_idx] = vlan_id;
+	while (dirty != 0U) {
+		idx = vlan_lowest_bit(dirty);
 
-	val = osi_readl((nveu8_t *)osi_core->base + MAC_VLAN_TAG_DATA);
-	val &= (nveu32_t) ~VLAN_VID_MASK;
-	val |= (vlan_id | MAC_VLAN_TAG_DATA_ETV | MAC_VLAN_TAG_DATA_VEN);
+		val = 0U;
+		if ((osi_core->vf_bitmap & OSI_BIT(idx)) != 0U) {
+			val = (osi_core->vid[idx] | MAC_VLAN_TAG_DATA_ETV |
+			       MAC_VLAN_TAG_DATA_VEN);
+		}
 
-	ret = update_vlan_filters(osi_core, vid_idx, val);
-	if (ret < 0) {
-		return -1;
+		ret = update_vlan_filters(osi_core, idx, val);
+		if (ret < 0) {
+			goto done;
+		}
+		dirty &= ~OSI_BIT(idx);
 	}
 
-	for (i = VLAN_HW_FILTER_FULL_IDX; i <=  osi_core->vlan_filter_cnt; i++) {
-		osi_core->vid[i] = osi_core->vid[i + 1U];
+	if ((old_cnt > 0U) && (osi_core->vlan_filter_cnt == 0U)) {
+		ret = ops_p->config_vlan_filtering(osi_core, OSI_DISABLE,
+						   OSI_DISABLE, OSI_DISABLE);
+		if (ret < 0) {
+			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+				"Failed to disable VLAN filtering\n", 0ULL);
+			goto done;
+		}
 	}
 
-	osi_core->vid[i] = VLAN_ID_INVALID;
+	config_vlan_hash(l_core, osi_core->vlan_filter_cnt - hw_cnt);
 
-	return 0;
+done:
+	/* HW filters not written yet, next sync writes them */
+	l_core->vlan_dirty = dirty;
+	return ret;
 }
 
 /**
- * @brief del_vlan_id - Delete VLAN ID.
- *
- * Algorithm: Delete VLAN ID from HW filters or SW VID array.
+ * @brief vlan_fits - Check VLAN set size against HW filtering capacity
  *
  * @param[in] osi_core: OSI core private data.
- * @param[in] val: VLAN ID to be deleted
+ * @param[in] cnt: VLAN set size.
  *
- * @return 0 on success
- * @return -1 on failure.
+ * @return 0 if VIDs fit in perfect or hash filter
+ * @return -1 otherwise.
  */
-static inline nve32_t del_vlan_id(struct osi_core_priv_data *osi_core,
-			      struct core_ops *ops_p,
-			      nveu16_t vlan_id)
+static nve32_t vlan_fits(struct osi_core_priv_data *osi_core, nveu32_t cnt)
 {
-	nveu32_t vid_idx = 0;
-	nveu32_t val = 0;
-	nveu32_t idx;
 	nve32_t ret = 0;
 
-	/* Search for vlan filter index to be deleted */
-	vid_idx = get_vlan_filter_idx(osi_core, vlan_id);
-	if (vid_idx == VLAN_HW_FILTER_FULL_IDX) {
-		ret = is_vlan_id_enqueued(osi_core, vlan_id, &idx);
-		if (ret != 0) {
-			/* VID not found in HW/SW filter list */
-			return -1;
-		}
-		return dequeue_vlan_id(osi_core, idx);
+	if ((cnt > VLAN_HW_MAX_NRVF) &&
+	    (vlan_hash_supported(osi_core) == OSI_DISABLE)) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_OUTOFBOUND,
+			     "VLAN filters full and no VLAN hash filter\n",
+			     (nveul64_t)cnt);
+		ret = -1;
 	}
 
-	osi_core->vf_bitmap &= ~OSI_BIT(vid_idx);
-	osi_core->vid[vid_idx] = VLAN_ID_INVALID;
+	return ret;
+}
 
-	ret = update_vlan_filters(osi_core, vid_idx, val);
+nve32_t update_vlan_id(struct osi_core_priv_data *osi_core,
+		   struct core_ops *ops_p,
+		   nveu32_t vid)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t action = vid & VLAN_ACTION_MASK;
+	nveu16_t vlan_id = (nveu16_t)(vid & VLAN_VID_MASK);
+	nveu32_t old_cnt = osi_core->vlan_filter_cnt;
+	nve32_t ret;
+
+	if ((action == OSI_VLAN_ACTION_ADD) &&
+	    (vlan_bit_test(l_core->vlan_set, vlan_id) == OSI_DISABLE)) {
+		ret = vlan_fits(osi_core, old_cnt + 1U);
+		if (ret < 0) {
+			goto done;
+		}
+	}
+
+	ret = vlan_set_update(l_core, vlan_id,
+			      (action == OSI_VLAN_ACTION_ADD) ?
+			      OSI_ENABLE : OSI_DISABLE);
 	if (ret < 0) {
-		return -1;
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "VLAN ID already added or not found\n",
+			     (nveul64_t)vlan_id);
+		goto done;
 	}
 
-	osi_core->vlan_filter_cnt--;
+	ret = sync_vlan_filters(osi_core, ops_p, old_cnt);
 
-	if (osi_core->vlan_filter_cnt == 0U) {
-		ret = ops_p->config_vlan_filtering(osi_core,
-						   OSI_DISABLE,
-						   OSI_DISABLE,
-						   OSI_DISABLE);
-		if (ret < 0) {
+done:
+	return ret;
+}
+
+nve32_t update_vlan_list(struct osi_core_priv_data *osi_core,
+			 struct core_ops *ops_p,
+			 const struct osi_vlan_list *list)
+{
+	struct core_local *l_core = (struct core_local *)(void *)osi_core;
+	nveu32_t old_cnt = osi_core->vlan_filter_cnt;
+	nveu32_t add = OSI_DISABLE;
+	nveu32_t cnt = old_cnt;
+	nveu32_t i;
+	nve32_t ret = -1;
+
+	if ((list->count > VLAN_NUM_VID) ||
+	    ((list->count != 0U) && (list->vid == OSI_NULL)) ||
+	    ((list->action != OSI_VLAN_ACTION_ADD) &&
+	     (list->action != OSI_VLAN_ACTION_DEL))) {
+		OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
+			     "Invalid VLAN list\n", (nveul64_t)list->count);
+		goto done;
+	}
+
+	for (i = 0U; i < list->count; i++) {
+		if (list->vid[i] >= VLAN_NUM_VID) {
 			OSI_CORE_ERR(osi_core->osd, OSI_LOG_ARG_INVALID,
-				"Failed to disable VLAN filtering\n", 0ULL);
-			return -1;
+				     "Invalid VLAN ID\n",
+				     (nveul64_t)list->vid[i]);
+			goto done;
+		}
+
+		/* Duplicates in list are counted, only makes check stricter */
+		if (vlan_bit_test(l_core->vlan_set, list->vid[i]) ==
+		    OSI_DISABLE) {
+			cnt++;
 		}
 	}
 
-	if (osi_core->vlan_filter_cnt == VLAN_HW_MAX_NRVF) {
-		ret = allow_all_vid_tags(osi_core->base, OSI_DISABLE);
+	if (list->action == OSI_VLAN_ACTION_ADD) {
+		add = OSI_ENABLE;
+		ret = vlan_fits(osi_core, cnt);
 		if (ret < 0) {
-			return -1;
+			goto done;
 		}
 	}
 
-	/* if SW queue is not empty dequeue from SW queue and update filter */
-	return dequeue_vid_to_add_filter_reg(osi_core, vid_idx);
-}
-
-nve32_t update_vlan_id(struct osi_core_priv_data *osi_core,
-		   struct core_ops *ops_p,
-		   nveu32_t vid)
-{
-	nveu32_t action = vid & VLAN_ACTION_MASK;
-	nveu16_t vlan_id = (nveu16_t)(vid & VLAN_VID_MASK);
-
-	if (action == OSI_VLAN_ACTION_ADD) {
-		return add_vlan_id(osi_core, ops_p, vlan_id);
+	/* VIDs already in the requested state are skipped */
+	for (i = 0U; i < list->count; i++) {
+		(void)vlan_set_update(l_core, list->vid[i], add);
 	}
 
-	return del_vlan_id(osi_core, ops_p, vlan_id);
+	ret = sync_vlan_filters(osi_core, ops_p, old_cnt);
+
+done:
+	return ret;
 }
 #endif /* !OSI_STRIPPED_LIB */
@@ -42,6 +42,7 @@
 #define MAC_VLAN_TAG_CTRL_CT	OSI_BIT(1)
 #define MAC_VLAN_TAG_CTRL_OB	OSI_BIT(0)
 #define MAC_VLAN_TAG_CTRL_VHTM	OSI_BIT(25)
+#define MAC_VLAN_TAG_CTRL_ETV	OSI_BIT(16)
 #define MAC_VLAN_TAG_DATA_ETV	OSI_BIT(16)
 #define MAC_VLAN_TAG_DATA_VEN	OSI_BIT(17)
 /** @} */
@@ -58,12 +59,14 @@
 #define VLAN_ID_INVALID		0xFFFFU
 #define VLAN_HASH_ALLOW_ALL	0xFFFFU
 #define VLAN_ACTION_MASK	OSI_BIT(31)
+#define VLAN_VID_BITS		12U
+#define VLAN_RESTORE_BATCH	64U
 /** @} */
 
 /**
  * @brief update_vlan_id - Add/Delete VLAN ID.
  *
- * Algorithm: Add/deleted VLAN ID from HW filters or SW VID array.
+ * Algorithm: Add/delete VLAN ID in VLAN set and sync HW filters.
  *
  * @param[in] osi_core: OSI core private data.
  * @param[in] vid: VLAN ID to be added/deleted
@@ -73,5 +76,21 @@
  */
 nve32_t update_vlan_id(struct osi_core_priv_data *osi_core,
 		       struct core_ops *ops_p, nveu32_t vid);
+
+/**
+ * @brief update_vlan_list - Add/Delete a list of VLAN IDs.
+ *
+ * Algorithm: Update VLAN set for all VIDs in the list, then sync HW
+ * filters once. VIDs already in the requested state are skipped.
+ *
+ * @param[in] osi_core: OSI core private data.
+ * @param[in] list: VLAN ID list
+ *
+ * @return 0 on success
+ * @return -1 on failure.
+ */
+nve32_t update_vlan_list(struct osi_core_priv_data *osi_core,
+			 struct core_ops *ops_p,
+			 const struct osi_vlan_list *list);
 #endif /* !OSI_STRIPPED_LIB */
 #endif /* VLAN_FILTER_H */
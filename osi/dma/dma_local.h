@@ -79,11 +79,6 @@ struct desc_ops {
 	void (*get_rx_hash)(struct osi_rx_desc *rx_desc,
 			    struct osi_rx_pkt_cx *rx_pkt_cx);
 #endif /* !OSI_STRIPPED_LIB */
-	/** Called to get RX hw timestamp */
-	nve32_t (*get_rx_hwstamp)(const struct osi_dma_priv_data *const osi_dma,
-				  const struct osi_rx_desc *const rx_desc,
-				  const struct osi_rx_desc *const context_desc,
-				  struct osi_rx_pkt_cx *rx_pkt_cx);
 };
 
 /**
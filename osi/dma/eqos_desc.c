@@ -170,75 +170,6 @@ static void eqos_get_rx_csum(const struct osi_rx_desc *const rx_desc,
 	return;
 }
 
-/**
- * @brief eqos_get_rx_hwstamp - Get Rx HW Time stamp
- *
- * Algorithm:
- *	1) Check for TS availability.
- *	2) call get_tx_tstamp_status if TS is valid or not.
- *	3) If yes, set a bit and update nano seconds in rx_pkt_cx so that OSD
- *	layer can extract the time by checking this bit.
- *
- * @param[in] rx_desc: Rx descriptor
- * @param[in] context_desc: Rx context descriptor
- * @param[in] rx_pkt_cx: Rx packet context
- *
- * @retval -1 if TimeStamp is not available
- * @retval 0 if TimeStamp is available.
- */
-static nve32_t eqos_get_rx_hwstamp(const struct osi_dma_priv_data *const osi_dma,
-				   const struct osi_rx_desc *const rx_desc,
-				   const struct osi_rx_desc *const context_desc,
-				   struct osi_rx_pkt_cx *rx_pkt_cx)
-{
-	nve32_t ret = 0;
-	nve32_t retry;
-
-	/* Check for RS1V/TSA/TD valid */
-	if (((rx_desc->rdes3 & RDES3_RS1V) == RDES3_RS1V) &&
-	    ((rx_desc->rdes1 & RDES1_TSA) == RDES1_TSA) &&
-	    ((rx_desc->rdes1 & RDES1_TD) == 0U)) {
-		for (retry = 0; retry < 10; retry++) {
-			if (((context_desc->rdes3 & RDES3_OWN) == 0U) &&
-			    ((context_desc->rdes3 & RDES3_CTXT) ==
-			     RDES3_CTXT)) {
-				if ((context_desc->rdes0 ==
-				     OSI_INVALID_VALUE) &&
-				    (context_desc->rdes1 ==
-				     OSI_INVALID_VALUE)) {
-					ret = -1;
-					goto fail;
-				}
-				/* Update rx pkt context flags to indicate
-				 * PTP */
-				rx_pkt_cx->flags |= OSI_PKT_CX_PTP;
-				/* Time Stamp can be read */
-				break;
-			} else {
-				/* TS not available yet, so retrying */
-				osi_dma->osd_ops.udelay(OSI_DELAY_1US);
-			}
-		}
-		if (retry == 10) {
-			/* Timed out waiting for Rx timestamp */
-			ret = -1;
-			goto fail;
-		}
-
-		rx_pkt_cx->ns = context_desc->rdes0 +
-				(OSI_NSEC_PER_SEC * context_desc->rdes1);
-		if (rx_pkt_cx->ns < context_desc->rdes0) {
-			/* Will not hit this case */
-			ret = -1;
-			goto fail;
-		}
-	} else {
-		ret = -1;
-	}
-fail:
-	return ret;
-}
-
 void eqos_init_desc_ops(struct desc_ops *p_dops)
 {
 #ifndef OSI_STRIPPED_LIB
@@ -247,5 +178,4 @@ void eqos_init_desc_ops(struct desc_ops *p_dops)
 	p_dops->get_rx_hash = eqos_get_rx_hash;
 #endif /* !OSI_STRIPPED_LIB */
 	p_dops->get_rx_csum = eqos_get_rx_csum;
-	p_dops->get_rx_hwstamp = eqos_get_rx_hwstamp;
 }
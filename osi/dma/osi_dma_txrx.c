@@ -93,6 +93,88 @@ fail:
 	return ret;
 }
 
+/**
+ * @brief get_rx_hwstamp - Get Rx HW time stamp for a received packet
+ *
+ * @note
+ * Algorithm:
+ *  - Check normal descriptor for context descriptor indication and
+ *    return right away when no time stamp is present.
+ *  - Wait for context descriptor to be released by HW with valid
+ *    time stamp status.
+ *  - Update nano seconds and PTP flag in rx_pkt_cx directly.
+ *
+ * @param[in] osi_dma: OSI DMA private data structure.
+ * @param[in] rx_desc: Rx descriptor
+ * @param[in] context_desc: Rx context descriptor
+ * @param[out] rx_pkt_cx: Rx packet context
+ *
+ * @note
+ * API Group:
+ * - Initialization: No
+ * - Run time: Yes
+ * - De-initialization: No
+ *
+ * @retval -1 if TimeStamp is not available
+ * @retval 0 if TimeStamp is available and context descriptor is consumed.
+ */
+static inline nve32_t get_rx_hwstamp(const struct osi_dma_priv_data *const osi_dma,
+				     const struct osi_rx_desc *const rx_desc,
+				     const struct osi_rx_desc *const context_desc,
+				     struct osi_rx_pkt_cx *rx_pkt_cx)
+{
+	nveu32_t ctx_mask = RDES3_OWN | RDES3_CTXT;
+	nveu32_t ctx_val = RDES3_CTXT;
+	nve32_t ret = -1;
+	nve32_t retry;
+
+	if (osi_dma->mac == OSI_MAC_HW_MGBE) {
+		if ((rx_desc->rdes3 & RDES3_CDA) != RDES3_CDA) {
+			goto fail;
+		}
+		/* MGBE context descriptor carries TS status as well */
+		ctx_mask |= (RDES3_TSA | RDES3_TSD);
+		ctx_val |= RDES3_TSA;
+	} else {
+		/* Check for RS1V/TSA/TD valid */
+		if (((rx_desc->rdes3 & RDES3_RS1V) != RDES3_RS1V) ||
+		    ((rx_desc->rdes1 & (RDES1_TSA | RDES1_TD)) != RDES1_TSA)) {
+			goto fail;
+		}
+	}
+
+	for (retry = 0; retry < 10; retry++) {
+		if ((context_desc->rdes3 & ctx_mask) == ctx_val) {
+			/* Time Stamp can be read */
+			break;
+		}
+		/* TS not available yet, so retrying */
+		osi_dma->osd_ops.udelay(OSI_DELAY_1US);
+	}
+
+	if (retry == 10) {
+		/* Timed out waiting for Rx timestamp */
+		goto fail;
+	}
+
+	if ((context_desc->rdes0 == OSI_INVALID_VALUE) &&
+	    (context_desc->rdes1 == OSI_INVALID_VALUE)) {
+		/* Invalid time stamp */
+		goto fail;
+	}
+
+	rx_pkt_cx->ns = context_desc->rdes0 +
+			(OSI_NSEC_PER_SEC * context_desc->rdes1);
+	if (rx_pkt_cx->ns >= context_desc->rdes0) {
+		/* Update rx pkt context flags to indicate PTP */
+		rx_pkt_cx->flags |= OSI_PKT_CX_PTP;
+		ret = 0;
+	}
+
+fail:
+	return ret;
+}
+
 nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 				   nveu32_t chan, nve32_t budget,
 				   nveu32_t *more_data_avail)
@@ -221,8 +303,8 @@ nve32_t osi_process_rx_completions(struct osi_dma_priv_data *osi_dma,
 #endif /* !OSI_STRIPPED_LIB */
 			context_desc = rx_ring->rx_desc + rx_ring->cur_rx_idx;
 			/* Get rx time stamp */
-			ret = d_ops[ip_type].get_rx_hwstamp(osi_dma, rx_desc,
-						  context_desc, rx_pkt_cx);
+			ret = get_rx_hwstamp(osi_dma, rx_desc, context_desc,
+					     rx_pkt_cx);
 			if (ret == 0) {
 				ptp_rx_swcx = rx_ring->rx_swcx +
 					      rx_ring->cur_rx_idx;
@@ -684,6 +766,25 @@ fail:
 	return processed;
 }
 
+/**
+ * @brief is_ptp_onestep_pkt - check if PTP packet is sent in one-step mode
+ *
+ * @param[in] tx_pkt_cx: Pointer to transmit packet context structure
+ * @param[in] ptp_flag: osi statructure variable to identify current ptp
+ *			configuration
+ *
+ * @retval 1 if packet is requested as one-step sync or one-step mode is set
+ * @retval 0 otherwise.
+ */
+static inline nveu32_t is_ptp_onestep_pkt(const struct osi_tx_pkt_cx *const tx_pkt_cx,
+					  nveu32_t ptp_flag)
+{
+	return (((tx_pkt_cx->flags & OSI_PKT_CX_ONESTEP_SYNC) ==
+		 OSI_PKT_CX_ONESTEP_SYNC) ||
+		((ptp_flag & OSI_PTP_SYNC_ONESTEP) == OSI_PTP_SYNC_ONESTEP)) ?
+	       OSI_ENABLE : OSI_DISABLE;
+}
+
 /**
  * @brief need_cntx_desc - Helper function to check if context desc is needed.
  *
@@ -747,14 +848,16 @@ static inline nve32_t need_cntx_desc(const struct osi_tx_pkt_cx *const tx_pkt_cx
 		/* This part of code must be at the end of function */
 		if ((tx_pkt_cx->flags & OSI_PKT_CX_PTP) == OSI_PKT_CX_PTP) {
 			if (((mac == OSI_MAC_HW_EQOS) &&
-			    ((ptp_sync_flag & OSI_PTP_SYNC_TWOSTEP) == OSI_PTP_SYNC_TWOSTEP))) {
+			    ((ptp_sync_flag & OSI_PTP_SYNC_TWOSTEP) == OSI_PTP_SYNC_TWOSTEP) &&
+			    ((tx_pkt_cx->flags & OSI_PKT_CX_ONESTEP_SYNC) !=
+			     OSI_PKT_CX_ONESTEP_SYNC))) {
 				/* Doing nothing */
 			} else {
 				/* Set context type */
 				tx_desc->tdes3 |= TDES3_CTXT;
 				/* in case of One-step sync */
-				if ((ptp_sync_flag & OSI_PTP_SYNC_ONESTEP) ==
-				    OSI_PTP_SYNC_ONESTEP) {
+				if (is_ptp_onestep_pkt(tx_pkt_cx, ptp_sync_flag) ==
+				    OSI_ENABLE) {
 					/* Set TDES3_OSTC */
 					tx_desc->tdes3 |= TDES3_OSTC;
 					tx_desc->tdes3 &= ~TDES3_TCMSSV;
@@ -845,12 +948,19 @@ static inline void fill_first_desc(OSI_UNUSED struct osi_tx_ring *tx_ring,
 
 	/* if TS is set enable timestamping */
 	if ((tx_pkt_cx->flags & OSI_PKT_CX_PTP) == OSI_PKT_CX_PTP) {
-		tx_desc->tdes2 |= TDES2_TTSE;
-		tx_swcx->flags |= OSI_PKT_CX_PTP;
-		//ptp master mode in one step sync
-		if (is_ptp_onestep_and_master_mode(ptp_flag) ==
-		    OSI_ENABLE) {
-			tx_desc->tdes2 &= ~TDES2_TTSE;
+		if ((tx_pkt_cx->flags & OSI_PKT_CX_ONESTEP_SYNC) ==
+		    OSI_PKT_CX_ONESTEP_SYNC) {
+			/* HW updates sync message on the fly, no TX
+			 * time stamp to be reported back for this packet
+			 */
+		} else {
+			tx_desc->tdes2 |= TDES2_TTSE;
+			tx_swcx->flags |= OSI_PKT_CX_PTP;
+			//ptp master mode in one step sync
+			if (is_ptp_onestep_and_master_mode(ptp_flag) ==
+			    OSI_ENABLE) {
+				tx_desc->tdes2 &= ~TDES2_TTSE;
+			}
 		}
 	}
 
@@ -1045,6 +1155,17 @@ nve32_t hw_transmit(struct osi_dma_priv_data *osi_dma,
 			osi_update_stats_counter(osi_dma->dstats.tx_tso_pkt_n,
 						 1UL);
 	}
+
+	/* One-step mode only rewrites Sync, sent by master with PTP flag */
+	if (((tx_pkt_cx->flags & OSI_PKT_CX_PTP) == OSI_PKT_CX_PTP) &&
+	    (((tx_pkt_cx->flags & OSI_PKT_CX_ONESTEP_SYNC) ==
+	      OSI_PKT_CX_ONESTEP_SYNC) ||
+	     (is_ptp_onestep_and_master_mode(osi_dma->ptp_flag) ==
+	      OSI_ENABLE))) {
+		osi_dma->dstats.q_tx_onestep_pkt_n[chan] =
+			osi_update_stats_counter(
+				osi_dma->dstats.q_tx_onestep_pkt_n[chan], 1UL);
+	}
 #endif /* !OSI_STRIPPED_LIB */
 
 	cntx_desc_consumed = need_cntx_desc(tx_pkt_cx, tx_swcx, tx_desc,
@@ -1054,8 +1175,8 @@ nve32_t hw_transmit(struct osi_dma_priv_data *osi_dma,
 		    (osi_dma->mac == OSI_MAC_HW_MGBE)) {
 			/* mark packet id valid */
 			tx_desc->tdes3 |= TDES3_PIDV;
-			if ((osi_dma->ptp_flag & OSI_PTP_SYNC_ONESTEP) ==
-			    OSI_PTP_SYNC_ONESTEP) {
+			if (is_ptp_onestep_pkt(tx_pkt_cx, osi_dma->ptp_flag) ==
+			    OSI_ENABLE) {
 				/* packet ID for Onestep is 0x0 always */
 				pkt_id = OSI_NONE;
 			} else {